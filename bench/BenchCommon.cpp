@@ -0,0 +1,36 @@
+#include "BenchCommon.h"
+#include "EmojiManager.h"
+#include "debug/GLog.h"
+#include <cstdlib>
+#include <mutex>
+
+#ifndef LMS_SOURCE_DIR
+#define LMS_SOURCE_DIR "."
+#endif
+
+namespace Bench {
+    std::string AssetPath(const std::string& relativePath)
+    {
+        const char* assets = std::getenv("LMS_BENCH_ASSETS");
+        std::string root = assets ? assets : LMS_SOURCE_DIR "/assets";
+        return root + "/" + relativePath;
+    }
+
+    void InitLogging()
+    {
+        static std::once_flag once;
+        std::call_once(once, [] {
+            GLog::init("lms_bench_log.txt");
+            GLog::setLogLevel(GLogLevel::GLOG_WARN);
+        });
+    }
+
+    void LoadEmojis()
+    {
+        static std::once_flag once;
+        std::call_once(once, [] {
+            InitLogging();
+            EmojiManager::LoadEmojiMetadata(AssetPath("emojis/openmoji.json"));
+        });
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+
+// Shared setup for the lms_bench suite
+namespace Bench {
+    // Assets are read from $LMS_BENCH_ASSETS when it is set, otherwise from the source tree's assets/
+    std::string AssetPath(const std::string& relativePath);
+    // GLog writes to lms_bench_log.txt at WARN and up so the benchmark output stays readable
+    void InitLogging();
+    // Loads openmoji.json once per process, like the client does at startup
+    void LoadEmojis();
+}
@@ -0,0 +1,271 @@
+// Emoji metadata: loading openmoji.json, :shortcode: replacement in chat text, chat message
+// tokenizing and replay against the old per-frame parser, and shortcode lookup
+#include "BenchCommon.h"
+#include "EmojiIndex.h"
+#include "EmojiManager.h"
+#include "MessageLayout.h"
+#include "debug/GAllocCounter.h"
+#include "utils/FrameArena.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+enum CorpusKind {
+    CORPUS_PLAIN, // No shortcodes at all
+    CORPUS_MIXED, // About one shortcode per sentence, plus colons that are not shortcodes
+    CORPUS_DENSE, // Mostly shortcodes
+};
+
+static const char* WORDS[] = {"the", "build", "is", "green", "again", "see", "you", "at", "lunch", "thanks",
+                              "for", "the", "review", "merged", "ship", "it", "tomorrow", "works", "on", "my", "machine"};
+
+// Chat-like messages of roughly messageBytes each, the same for every run
+static std::vector<std::string> MakeCorpus(CorpusKind kind, size_t messageBytes, size_t messageCount)
+{
+    std::mt19937 rng(1234);
+    uint32_t emojiCount = EmojiManager::GetEmojiCount();
+    std::vector<std::string> messages(messageCount);
+    for (std::string& message : messages) {
+        while (message.size() < messageBytes) {
+            uint32_t roll = rng() % 100;
+            bool shortcode = emojiCount > 0 && ((kind == CORPUS_MIXED && roll < 10) || (kind == CORPUS_DENSE && roll < 80));
+            if (shortcode) {
+                message += EmojiManager::GetEmojiShortcode(rng() % emojiCount);
+            } else if (kind == CORPUS_MIXED && roll < 13) {
+                message += "12:30"; // Colon that has to be rejected
+            } else {
+                message += WORDS[rng() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+            }
+            message += ' ';
+        }
+    }
+    return messages;
+}
+
+static void BM_LoadEmojiMetadata(benchmark::State& state)
+{
+    Bench::LoadEmojis();
+    std::string jsonPath = Bench::AssetPath("emojis/openmoji.json");
+    for (auto _ : state) {
+        EmojiManager::LoadEmojiMetadata(jsonPath); // Maps the baked index when it is up to date
+        benchmark::DoNotOptimize(EmojiManager::GetEmojiCount());
+    }
+    state.counters["emojis"] = EmojiManager::GetEmojiCount();
+}
+BENCHMARK(BM_LoadEmojiMetadata)->Unit(benchmark::kMicrosecond);
+
+// The fallback when openmoji.idx is missing or stale, and the emoji_index_baker's work
+static void BM_BuildEmojiIndexFromJson(benchmark::State& state)
+{
+    Bench::InitLogging();
+    std::string jsonPath = Bench::AssetPath("emojis/openmoji.json");
+    std::vector<unsigned char> image;
+    std::string error;
+    for (auto _ : state) {
+        if (!EmojiIndexBuilder::BuildFromJson(jsonPath, image, error)) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(image.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * image.size()));
+}
+BENCHMARK(BM_BuildEmojiIndexFromJson)->Unit(benchmark::kMillisecond);
+
+// Args: corpus kind, bytes per message
+static void BM_ReplaceEmojiNames(benchmark::State& state)
+{
+    Bench::LoadEmojis();
+    const size_t MESSAGE_COUNT = 256;
+    std::vector<std::string> corpus = MakeCorpus(static_cast<CorpusKind>(state.range(0)), static_cast<size_t>(state.range(1)), MESSAGE_COUNT);
+    size_t corpusBytes = 0;
+    for (const std::string& message : corpus) corpusBytes += message.size();
+
+    for (auto _ : state) {
+        for (const std::string& message : corpus) {
+            FrameString replaced = EmojiManager::ReplaceEmojiNames(message);
+            benchmark::DoNotOptimize(replaced.data());
+        }
+        FrameArena::get().reset(); // Once per frame in the client
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * corpusBytes));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MESSAGE_COUNT));
+}
+BENCHMARK(BM_ReplaceEmojiNames)
+    ->ArgNames({"corpus", "bytes"})
+    ->ArgsProduct({{CORPUS_PLAIN, CORPUS_MIXED, CORPUS_DENSE}, {64, 512, 4096}});
+
+// Chat message rendering before and after messages were tokenized once. The
+// draw calls are stand-ins, so only the text handling and emoji lookups are measured.
+static void DrawText(const char* begin, const char* end)
+{
+    benchmark::DoNotOptimize(begin);
+    benchmark::DoNotOptimize(end);
+}
+
+static void DrawEmoji(uint32_t emojiId)
+{
+    benchmark::DoNotOptimize(emojiId);
+}
+
+// ✅ The RenderMessage loop from before tokenizing, kept here as the baseline. The shortcode
+// lookup is what GetEmojiTexture(const std::string&) did, minus its error log.
+static void LegacyRenderMessage(const std::string& message)
+{
+    std::string processedMessage = message;
+    size_t pos = 0;
+
+    while ((pos = processedMessage.find(':')) != std::string::npos) {
+        size_t endPos = processedMessage.find(':', pos + 1);
+        if (endPos == std::string::npos) break;
+
+        std::string emojiName = processedMessage.substr(pos, endPos - pos + 1);
+        std::string textBeforeEmoji = processedMessage.substr(0, pos);
+
+        if (!textBeforeEmoji.empty()) {
+            DrawText(textBeforeEmoji.c_str(), textBeforeEmoji.c_str() + textBeforeEmoji.size());
+        }
+
+        uint32_t emojiId = EmojiManager::FindEmoji(emojiName);
+        if (emojiId != EmojiManager::INVALID_EMOJI_ID) {
+            DrawEmoji(emojiId);
+        } else {
+            DrawText(emojiName.c_str(), emojiName.c_str() + emojiName.size());
+        }
+
+        processedMessage = processedMessage.substr(endPos + 1);
+    }
+
+    if (!processedMessage.empty()) {
+        DrawText(processedMessage.c_str(), processedMessage.c_str() + processedMessage.size());
+    }
+}
+
+// Same walk as RenderMessage over the spans ChatHistory stored when the message was added
+static void ReplayMessageSpans(const std::string& message, const std::vector<MessageSpan>& spans)
+{
+    const char* text = message.c_str();
+    for (const MessageSpan& span : spans) {
+        if (span.emojiId == EmojiManager::INVALID_EMOJI_ID) {
+            DrawText(text + span.begin, text + span.begin + span.length);
+        } else {
+            DrawEmoji(span.emojiId);
+        }
+    }
+}
+
+// Heap allocations made during the timed loop, counted when the build defines LMS_COUNT_ALLOCATIONS
+class AllocationDelta {
+public:
+    AllocationDelta() : start(GAllocCounter::get()) {}
+
+    GAllocStats get() const
+    {
+        GAllocStats end = GAllocCounter::get();
+        return GAllocStats{end.allocations - start.allocations, end.bytes - start.bytes, end.frees - start.frees};
+    }
+
+private:
+    GAllocStats start;
+};
+
+// Time and allocations per message instead of per pass over the corpus
+static void ReportPerMessage(benchmark::State& state, size_t messagesPerIteration, const AllocationDelta& allocations)
+{
+    double messages = static_cast<double>(state.iterations() * messagesPerIteration);
+    state.SetItemsProcessed(static_cast<int64_t>(messages));
+    state.counters["time_per_msg"] = benchmark::Counter(static_cast<double>(messagesPerIteration),
+                                                        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    if (!GAllocCounter::isEnabled() || messages == 0) return;
+    GAllocStats delta = allocations.get();
+    state.counters["allocs_per_msg"] = static_cast<double>(delta.allocations) / messages;
+    state.counters["alloc_bytes_per_msg"] = static_cast<double>(delta.bytes) / messages;
+}
+
+// Before: every frame re-parsed every message
+static void BM_RenderMessageLegacy(benchmark::State& state)
+{
+    Bench::LoadEmojis();
+    const size_t MESSAGE_COUNT = 256;
+    std::vector<std::string> corpus = MakeCorpus(static_cast<CorpusKind>(state.range(0)), static_cast<size_t>(state.range(1)), MESSAGE_COUNT);
+
+    AllocationDelta allocations;
+    for (auto _ : state) {
+        for (const std::string& message : corpus) LegacyRenderMessage(message);
+    }
+    ReportPerMessage(state, MESSAGE_COUNT, allocations);
+}
+BENCHMARK(BM_RenderMessageLegacy)
+    ->ArgNames({"corpus", "bytes"})
+    ->ArgsProduct({{CORPUS_PLAIN, CORPUS_MIXED, CORPUS_DENSE}, {64, 512}});
+
+// After, once per message: what ChatHistory::addMessage pays, a new span list included
+static void BM_TokenizeMessage(benchmark::State& state)
+{
+    Bench::LoadEmojis();
+    const size_t MESSAGE_COUNT = 256;
+    std::vector<std::string> corpus = MakeCorpus(static_cast<CorpusKind>(state.range(0)), static_cast<size_t>(state.range(1)), MESSAGE_COUNT);
+
+    AllocationDelta allocations;
+    for (auto _ : state) {
+        for (const std::string& message : corpus) {
+            std::vector<MessageSpan> spans;
+            MessageLayout::Tokenize(message, spans);
+            benchmark::DoNotOptimize(spans.data());
+        }
+    }
+    ReportPerMessage(state, MESSAGE_COUNT, allocations);
+}
+BENCHMARK(BM_TokenizeMessage)
+    ->ArgNames({"corpus", "bytes"})
+    ->ArgsProduct({{CORPUS_PLAIN, CORPUS_MIXED, CORPUS_DENSE}, {64, 512}});
+
+// After, every frame: replaying the stored spans, expected to make no allocations
+static void BM_ReplayMessageSpans(benchmark::State& state)
+{
+    Bench::LoadEmojis();
+    const size_t MESSAGE_COUNT = 256;
+    std::vector<std::string> corpus = MakeCorpus(static_cast<CorpusKind>(state.range(0)), static_cast<size_t>(state.range(1)), MESSAGE_COUNT);
+    std::vector<std::vector<MessageSpan>> spans(corpus.size());
+    for (size_t i = 0; i < corpus.size(); ++i) MessageLayout::Tokenize(corpus[i], spans[i]);
+
+    AllocationDelta allocations;
+    for (auto _ : state) {
+        for (size_t i = 0; i < corpus.size(); ++i) ReplayMessageSpans(corpus[i], spans[i]);
+    }
+    ReportPerMessage(state, MESSAGE_COUNT, allocations);
+}
+BENCHMARK(BM_ReplayMessageSpans)
+    ->ArgNames({"corpus", "bytes"})
+    ->ArgsProduct({{CORPUS_PLAIN, CORPUS_MIXED, CORPUS_DENSE}, {64, 512}});
+
+// Arg: 1 looks up known shortcodes in a shuffled order, 0 looks up names that are not emojis
+static void BM_FindEmoji(benchmark::State& state)
+{
+    Bench::LoadEmojis();
+    uint32_t emojiCount = EmojiManager::GetEmojiCount();
+    if (emojiCount == 0) {
+        state.SkipWithError("No emoji metadata loaded");
+        return;
+    }
+
+    bool hits = state.range(0) != 0;
+    std::vector<std::string> queries;
+    queries.reserve(emojiCount);
+    for (uint32_t id = 0; id < emojiCount; ++id) {
+        std::string shortcode(EmojiManager::GetEmojiShortcode(id));
+        if (!hits && !shortcode.empty()) shortcode.insert(1, "zz"); // Same length distribution, never matches
+        queries.push_back(std::move(shortcode));
+    }
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(1234));
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(EmojiManager::FindEmoji(queries[next]));
+        if (++next == queries.size()) next = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindEmoji)->ArgName("hit")->Arg(1)->Arg(0);
@@ -0,0 +1,64 @@
+// GLog throughput with 1, 4 and 16 threads logging at once. Records go through the async ring
+// to the file sink; the console sink only takes INFO and up, so nothing is printed.
+#include "BenchCommon.h"
+#include "debug/GLog.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+
+// The producers share the ring, so with the default GLOG_BLOCK policy this also measures
+// how fast the worker drains it once the ring is full
+static void BeginLogging(const benchmark::State& state)
+{
+    Bench::InitLogging();
+    if (state.thread_index() == 0) GLog::setLogLevel(GLogLevel::GLOG_DEBUG);
+}
+
+static void EndLogging(benchmark::State& state)
+{
+    if (state.thread_index() != 0) return;
+    GLog::flush();
+    GLog::setLogLevel(GLogLevel::GLOG_WARN);
+    state.counters["dropped"] = static_cast<double>(GLog::getDroppedCount());
+}
+
+// Formatted on the calling thread, like GLOG_DEBUG
+static void BM_GLogText(benchmark::State& state)
+{
+    BeginLogging(state);
+    int64_t frame = 0;
+    for (auto _ : state) {
+        GLog::log(GLogSourceLocation{__FILE__, __LINE__}, GLogLevel::GLOG_DEBUG, "Frame {} took {:.3f} ms, {} emojis resident", frame, 16.6, 512);
+        ++frame;
+    }
+    state.SetItemsProcessed(state.iterations());
+    EndLogging(state);
+}
+BENCHMARK(BM_GLogText)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+// Deferred formatting, like GLOG_DEBUG_BIN: only the arguments are copied into the ring
+static void BM_GLogBinary(benchmark::State& state)
+{
+    BeginLogging(state);
+    static std::atomic<uint32_t> formatId{0};
+    int64_t frame = 0;
+    for (auto _ : state) {
+        GLog::logBinary(formatId, GLogLevel::GLOG_DEBUG, __FILE__, __LINE__, "Frame {} took {:.3f} ms, {} emojis resident", frame, 16.6, 512);
+        ++frame;
+    }
+    state.SetItemsProcessed(state.iterations());
+    EndLogging(state);
+}
+BENCHMARK(BM_GLogBinary)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+// A line below the runtime level: one relaxed load, the arguments are never touched
+static void BM_GLogDisabled(benchmark::State& state)
+{
+    Bench::InitLogging();
+    int64_t frame = 0;
+    for (auto _ : state) {
+        if (GLog::shouldLog(GLogLevel::GLOG_DEBUG)) GLog::log(GLogLevel::GLOG_DEBUG, "Frame {}", frame);
+        benchmark::DoNotOptimize(++frame);
+    }
+}
+BENCHMARK(BM_GLogDisabled);
@@ -0,0 +1,56 @@
+// Emoji image costs on the CPU: PNG decode (the part of LoadTextureFromFile that does not need a
+// GL context) and the premultiply/mip work the loader does when no pre-decoded pack is available
+#include "BenchCommon.h"
+#include "utils/ImageOps.h"
+#include "utils/image.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+static const char* BENCH_EMOJI = "emojis/1F600.png";
+
+static void BM_LoadImageData(benchmark::State& state)
+{
+    Bench::InitLogging();
+    std::string path = Bench::AssetPath(BENCH_EMOJI);
+    int width = 0, height = 0;
+    for (auto _ : state) {
+        unsigned char* data = LoadImageData(path.c_str(), &width, &height);
+        if (!data) {
+            state.SkipWithError("Failed to decode the emoji image");
+            break;
+        }
+        benchmark::DoNotOptimize(data);
+        FreeImageData(data);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(width) * height * 4);
+    state.counters["width"] = width;
+    state.counters["height"] = height;
+}
+BENCHMARK(BM_LoadImageData)->Unit(benchmark::kMicrosecond);
+
+// Arg: mip levels below the decoded size
+static void BM_PrepareEmojiImage(benchmark::State& state)
+{
+    Bench::InitLogging();
+    std::string path = Bench::AssetPath(BENCH_EMOJI);
+    int width = 0, height = 0;
+    unsigned char* decoded = LoadImageData(path.c_str(), &width, &height);
+    if (!decoded) {
+        state.SkipWithError("Failed to decode the emoji image");
+        return;
+    }
+
+    int levelCount = static_cast<int>(state.range(0)) + 1;
+    std::vector<unsigned char> rgba(decoded, decoded + static_cast<size_t>(width) * height * 4);
+    std::vector<unsigned char> mips(GetMipChainBytes(width, height, levelCount));
+    FreeImageData(decoded);
+
+    for (auto _ : state) {
+        PremultiplyAlpha(rgba.data(), width, height); // Values drift over iterations, the cost does not
+        BuildMipChain(rgba.data(), width, height, levelCount, mips.data());
+        benchmark::DoNotOptimize(mips.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(rgba.size()));
+}
+BENCHMARK(BM_PrepareEmojiImage)->ArgName("mips")->Arg(0)->Arg(4)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,26 @@
+#include "ChatHistory.h"
+
+uint64_t ChatHistory::addMessage(const std::string& author, const std::string& text)
+{
+    ChatMessage message;
+    message.id = firstId + messages.size();
+    message.author = author;
+    message.text = text;
+    MessageLayout::Tokenize(message.text, message.spans);
+    messages.push_back(std::move(message));
+    return messages.back().id;
+}
+
+const ChatMessage* ChatHistory::findMessage(uint64_t id) const
+{
+    if (id < firstId || id - firstId >= messages.size()) return nullptr;
+    return &messages[id - firstId];
+}
+
+void ChatHistory::retokenize()
+{
+    for (ChatMessage& message : messages) {
+        MessageLayout::Tokenize(message.text, message.spans);
+    }
+    revision_++;
+}
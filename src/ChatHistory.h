@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MessageLayout.h"
+
+struct ChatMessage {
+    uint64_t id;
+    std::string author;
+    std::string text;
+    std::vector<MessageSpan> spans; // Tokenized once when the message is added
+};
+
+// Messages of one conversation, in arrival order. Ids are assigned sequentially,
+// so looking a message up by id is an index computation.
+class ChatHistory {
+public:
+    uint64_t addMessage(const std::string& author, const std::string& text);
+    const ChatMessage* findMessage(uint64_t id) const;
+
+    size_t size() const { return messages.size(); }
+    bool empty() const { return messages.empty(); }
+    const ChatMessage& operator[](size_t index) const { return messages[index]; }
+
+    // Re-resolves emoji spans, e.g. after the emoji metadata was reloaded
+    void retokenize();
+    // Bumped whenever existing messages change, so cached layouts of them can be dropped
+    uint32_t revision() const { return revision_; }
+
+private:
+    std::vector<ChatMessage> messages;
+    uint64_t firstId = 1;
+    uint32_t revision_ = 1;
+};
@@ -0,0 +1,78 @@
+#include "ChatView.h"
+
+void ChatView::sync(size_t messageCount, float estimatedHeight)
+{
+    if (messageCount < heights.size()) clear();
+    if (tree.empty()) tree.push_back(0.0);
+
+    while (heights.size() < messageCount) {
+        // tree[i] covers the rows (i - lowbit(i), i]; the new row is i, the rest is already summed
+        size_t i = heights.size() + 1;
+        size_t rangeStart = i - (i & (~i + 1));
+        tree.push_back(static_cast<double>(estimatedHeight) + offsetOf(i - 1) - offsetOf(rangeStart));
+        heights.push_back(estimatedHeight);
+        measuredGeneration.push_back(0);
+    }
+}
+
+void ChatView::setWrapWidth(float width)
+{
+    if (width == currentWrapWidth) return;
+    currentWrapWidth = width;
+    generation++;
+}
+
+void ChatView::invalidate()
+{
+    generation++;
+}
+
+void ChatView::clear()
+{
+    heights.clear();
+    measuredGeneration.clear();
+    tree.clear();
+    stickToBottom = true;
+}
+
+void ChatView::setHeight(size_t index, float height)
+{
+    measuredGeneration[index] = generation;
+    if (height == heights[index]) return;
+    add(index, static_cast<double>(height) - heights[index]);
+    heights[index] = height;
+}
+
+void ChatView::add(size_t index, double delta)
+{
+    for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1)) {
+        tree[i] += delta;
+    }
+}
+
+double ChatView::offsetOf(size_t index) const
+{
+    double sum = 0.0;
+    for (size_t i = index; i > 0; i -= i & (~i + 1)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+size_t ChatView::indexAt(double y) const
+{
+    if (heights.empty()) return 0;
+
+    // Descend the tree: find the longest prefix whose total height is still <= y
+    size_t position = 0;
+    size_t step = 1;
+    while (step * 2 < tree.size()) step *= 2;
+    for (; step > 0; step /= 2) {
+        size_t next = position + step;
+        if (next < tree.size() && tree[next] <= y) {
+            position = next;
+            y -= tree[next];
+        }
+    }
+    return position < heights.size() ? position : heights.size() - 1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Scroll bookkeeping for a virtualized chat log. Every message has a cached height,
+// measured for the current wrap width; offsets come from a Fenwick tree over those
+// heights, so mapping a scroll position to a message and updating one height are both
+// O(log n). Only the messages in view are ever measured or drawn.
+//
+// Changing the wrap width does not touch the rows: their heights are kept as estimates
+// and marked stale, and each is re-measured the next time it comes into view.
+class ChatView {
+public:
+    // Grows the view to messageCount rows, new rows start at estimatedHeight and unmeasured
+    void sync(size_t messageCount, float estimatedHeight);
+    void setWrapWidth(float width);
+    float wrapWidth() const { return currentWrapWidth; }
+    void invalidate(); // Marks every height stale, e.g. when the messages were tokenized again
+    void clear();
+
+    size_t size() const { return heights.size(); }
+    float height(size_t index) const { return heights[index]; }
+    bool isMeasured(size_t index) const { return measuredGeneration[index] == generation; }
+    // Stores the height measured at the current wrap width
+    void setHeight(size_t index, float height);
+
+    double offsetOf(size_t index) const; // Top of the message, sum of the heights before it
+    double totalHeight() const { return offsetOf(heights.size()); }
+    // Message that covers y, clamped to the last message; 0 when empty
+    size_t indexAt(double y) const;
+
+    // Whether the log should follow new messages; cleared when the user scrolls up
+    bool stickToBottom = true;
+
+private:
+    void add(size_t index, double delta);
+
+    std::vector<float> heights;
+    std::vector<uint32_t> measuredGeneration; // Generation the height was measured in
+    std::vector<double> tree;                 // Fenwick tree, 1-based, tree[0] unused
+    uint32_t generation = 1;                  // Bumped when the wrap width changes or on invalidate()
+    float currentWrapWidth = 0.0f;
+};
@@ -0,0 +1,315 @@
+#include "EmojiAtlas.h"
+#include "utils/ImageOps.h"
+#include "debug/GLogMacros.h"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+namespace EmojiAtlas {
+    // Images are packed into horizontal shelves. A shelf is as tall as the first
+    // image placed on it; later images only go on shelves they fit without
+    // wasting too much height.
+    struct Shelf {
+        int y;
+        int height;
+        int nextX;
+    };
+
+    struct FreeRect {
+        int x, y, width, height;
+    };
+
+    struct AtlasPage {
+        GLuint textureID = 0;
+        std::vector<Shelf> shelves;
+        std::vector<FreeRect> freeRects; // Slots released by Remove(), reused before new shelf space
+        int nextShelfY = 0;
+    };
+
+    std::vector<AtlasPage> pages;
+    std::unordered_map<uint32_t, AtlasRegion> regions;
+    std::vector<unsigned char> uploadScratch; // Padded copy of the image being uploaded
+    AtlasRegion placeholderRegion;
+
+    // Pixel buffer object used to stage a frame's worth of uploads
+    struct StagedUpload {
+        GLuint textureID;
+        int level;
+        int x, y, width, height;
+        size_t offset;
+    };
+
+    GLuint stagingBuffer = 0;
+    unsigned char* stagingData = nullptr; // Mapped while a batch is open
+    size_t stagingCapacity = 0;
+    size_t stagingUsed = 0;
+    std::vector<StagedUpload> stagedUploads;
+
+    static int AlignSlot(int size)
+    {
+        return (size + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1);
+    }
+
+    // Copies one level of the image into a slotW x slotH block, cleared around the image
+    static void WritePadded(unsigned char* dst, int slotW, int slotH, int padding, const unsigned char* rgba, int width, int height)
+    {
+        std::fill(dst, dst + static_cast<size_t>(slotW) * slotH * 4, 0);
+        for (int row = 0; row < height; ++row) {
+            std::copy(rgba + static_cast<size_t>(row) * width * 4,
+                      rgba + static_cast<size_t>(row + 1) * width * 4,
+                      dst + (static_cast<size_t>(row + padding) * slotW + padding) * 4);
+        }
+    }
+
+    static GLuint CreatePageTexture()
+    {
+        GLuint textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+
+        // Allocate every level of the page once; images are streamed in with glTexSubImage2D.
+        // The staging buffer must not be bound here or the null pointer reads from it.
+        if (stagingData) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        for (int level = 0; level < MIP_LEVELS; ++level) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, PAGE_SIZE >> level, PAGE_SIZE >> level, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, MIP_LEVELS - 1);
+        if (stagingData) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+
+        return textureID;
+    }
+
+    static bool AllocateOnPage(AtlasPage& page, int width, int height, int& outX, int& outY)
+    {
+        // Reuse an evicted slot first; emoji images are all the same size so this is the common case
+        for (size_t i = 0; i < page.freeRects.size(); ++i) {
+            const FreeRect& rect = page.freeRects[i];
+            if (rect.width >= width && rect.height >= height) {
+                outX = rect.x;
+                outY = rect.y;
+                page.freeRects[i] = page.freeRects.back();
+                page.freeRects.pop_back();
+                return true;
+            }
+        }
+
+        for (Shelf& shelf : page.shelves) {
+            bool fitsHeight = height <= shelf.height && height * 4 >= shelf.height * 3;
+            if (fitsHeight && shelf.nextX + width <= PAGE_SIZE) {
+                outX = shelf.nextX;
+                outY = shelf.y;
+                shelf.nextX += width;
+                return true;
+            }
+        }
+
+        if (page.nextShelfY + height > PAGE_SIZE || width > PAGE_SIZE) {
+            return false;
+        }
+
+        Shelf shelf{page.nextShelfY, height, width};
+        page.shelves.push_back(shelf);
+        page.nextShelfY += height;
+        outX = 0;
+        outY = shelf.y;
+        return true;
+    }
+
+    bool Insert(uint32_t key, const unsigned char* mipChain, int width, int height, AtlasRegion& outRegion)
+    {
+        Remove(key);
+
+        int slotW = AlignSlot(width + PADDING * 2);
+        int slotH = AlignSlot(height + PADDING * 2);
+        int pageIndex = -1;
+        int slotX = 0, slotY = 0;
+
+        for (size_t i = 0; i < pages.size(); ++i) {
+            if (AllocateOnPage(pages[i], slotW, slotH, slotX, slotY)) {
+                pageIndex = static_cast<int>(i);
+                break;
+            }
+        }
+
+        if (pageIndex < 0) {
+            if (static_cast<int>(pages.size()) >= MAX_PAGES) {
+                GLOG_WARN("Emoji atlas is full ({} pages), cannot insert emoji {}", MAX_PAGES, key);
+                return false;
+            }
+
+            AtlasPage page;
+            page.textureID = CreatePageTexture();
+            pages.push_back(page);
+            pageIndex = static_cast<int>(pages.size()) - 1;
+            GLOG_INFO("Allocated emoji atlas page {} ({}x{})", pageIndex, PAGE_SIZE, PAGE_SIZE);
+
+            if (!AllocateOnPage(pages[pageIndex], slotW, slotH, slotX, slotY)) {
+                GLOG_ERROR("Emoji image {} ({}x{}) does not fit in an atlas page", key, width, height);
+                return false;
+            }
+        }
+
+        // Upload every level together with a cleared border so stale texels from
+        // a previously evicted slot never show up in the padding
+        AtlasPage& page = pages[pageIndex];
+        const unsigned char* levelPixels = mipChain;
+        for (int level = 0; level < MIP_LEVELS; ++level) {
+            int levelW = std::max(1, width >> level);
+            int levelH = std::max(1, height >> level);
+            int levelSlotW = slotW >> level;
+            int levelSlotH = slotH >> level;
+            size_t levelSlotBytes = static_cast<size_t>(levelSlotW) * levelSlotH * 4;
+
+            if (stagingData && stagingUsed + levelSlotBytes <= stagingCapacity) {
+                WritePadded(stagingData + stagingUsed, levelSlotW, levelSlotH, PADDING >> level, levelPixels, levelW, levelH);
+                stagedUploads.push_back(StagedUpload{page.textureID, level, slotX >> level, slotY >> level, levelSlotW, levelSlotH, stagingUsed});
+                stagingUsed += levelSlotBytes;
+            } else {
+                uploadScratch.resize(levelSlotBytes);
+                WritePadded(uploadScratch.data(), levelSlotW, levelSlotH, PADDING >> level, levelPixels, levelW, levelH);
+                if (stagingData) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                glBindTexture(GL_TEXTURE_2D, page.textureID);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                glTexSubImage2D(GL_TEXTURE_2D, level, slotX >> level, slotY >> level, levelSlotW, levelSlotH, GL_RGBA, GL_UNSIGNED_BYTE,
+                                uploadScratch.data());
+                if (stagingData) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+            }
+            levelPixels += static_cast<size_t>(levelW) * levelH * 4;
+        }
+
+        AtlasRegion region;
+        region.textureID = page.textureID;
+        region.page = pageIndex;
+        region.x = slotX + PADDING;
+        region.y = slotY + PADDING;
+        region.width = width;
+        region.height = height;
+        region.u0 = static_cast<float>(region.x) / PAGE_SIZE;
+        region.v0 = static_cast<float>(region.y) / PAGE_SIZE;
+        region.u1 = static_cast<float>(region.x + width) / PAGE_SIZE;
+        region.v1 = static_cast<float>(region.y + height) / PAGE_SIZE;
+
+        regions[key] = region;
+        outRegion = region;
+        return true;
+    }
+
+    const AtlasRegion* Find(uint32_t key)
+    {
+        auto it = regions.find(key);
+        return it != regions.end() ? &it->second : nullptr;
+    }
+
+    void Remove(uint32_t key)
+    {
+        auto it = regions.find(key);
+        if (it == regions.end()) return;
+
+        const AtlasRegion& region = it->second;
+        FreeRect slot{region.x - PADDING, region.y - PADDING, AlignSlot(region.width + PADDING * 2), AlignSlot(region.height + PADDING * 2)};
+        pages[region.page].freeRects.push_back(slot);
+        regions.erase(it);
+    }
+
+    const AtlasRegion& GetPlaceholder()
+    {
+        if (Find(PLACEHOLDER_KEY)) return placeholderRegion;
+
+        // A faint grey square, the same footprint as the emoji it stands in for
+        const int size = 16;
+        std::vector<unsigned char> pixels(size * size * 4);
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            pixels[i + 0] = 128;
+            pixels[i + 1] = 128;
+            pixels[i + 2] = 128;
+            pixels[i + 3] = 64;
+        }
+        PremultiplyAlpha(pixels.data(), size, size);
+        std::vector<unsigned char> mipChain(GetMipChainBytes(size, size, MIP_LEVELS));
+        BuildMipChain(pixels.data(), size, size, MIP_LEVELS, mipChain.data());
+        Insert(PLACEHOLDER_KEY, mipChain.data(), size, size, placeholderRegion);
+        return placeholderRegion;
+    }
+
+    void BeginUploadBatch(size_t maxBytes)
+    {
+        if (stagingData) return;
+
+        if (stagingBuffer == 0) glGenBuffers(1, &stagingBuffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+
+        // Orphan the previous storage so mapping never waits on last frame's transfers
+        stagingCapacity = maxBytes;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(stagingCapacity), nullptr, GL_STREAM_DRAW);
+        stagingData = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(stagingCapacity),
+                                                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        stagingUsed = 0;
+        stagedUploads.clear();
+        if (!stagingData) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            GLOG_WARN("Failed to map emoji staging buffer, uploading directly.");
+        }
+    }
+
+    void EndUploadBatch()
+    {
+        if (!stagingData) return;
+
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        stagingData = nullptr;
+
+        // With a buffer bound to GL_PIXEL_UNPACK_BUFFER the data pointer is an offset into it
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        for (const StagedUpload& upload : stagedUploads) {
+            glBindTexture(GL_TEXTURE_2D, upload.textureID);
+            glTexSubImage2D(GL_TEXTURE_2D, upload.level, upload.x, upload.y, upload.width, upload.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(upload.offset));
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        stagedUploads.clear();
+    }
+
+    size_t GetRegionBytes(const AtlasRegion& region)
+    {
+        int slotW = AlignSlot(region.width + PADDING * 2);
+        int slotH = AlignSlot(region.height + PADDING * 2);
+        size_t bytes = 0;
+        for (int level = 0; level < MIP_LEVELS; ++level) {
+            bytes += static_cast<size_t>(slotW >> level) * (slotH >> level) * 4;
+        }
+        return bytes;
+    }
+
+    void Clear()
+    {
+        regions.clear();
+        for (AtlasPage& page : pages) {
+            page.shelves.clear();
+            page.freeRects.clear();
+            page.nextShelfY = 0;
+        }
+    }
+
+    int GetPageCount()
+    {
+        return static_cast<int>(pages.size());
+    }
+
+    void Shutdown()
+    {
+        for (const AtlasPage& page : pages) {
+            glDeleteTextures(1, &page.textureID);
+        }
+        if (stagingBuffer != 0) {
+            glDeleteBuffers(1, &stagingBuffer);
+            stagingBuffer = 0;
+        }
+        pages.clear();
+        regions.clear();
+    }
+}
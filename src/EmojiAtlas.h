@@ -0,0 +1,42 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+
+// A packed slot inside one of the atlas pages. UVs point at the image itself,
+// the padding around it stays transparent so mipmaps do not bleed.
+struct AtlasRegion {
+    GLuint textureID = 0;
+    int page = -1;
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+};
+
+namespace EmojiAtlas {
+    const int PAGE_SIZE = 1024; // Width and height of every atlas page in texels
+    const int MAX_PAGES = 8;    // Hard cap on GPU memory: 8 x 4 MB (+ mips)
+    const int PADDING = 4;      // Transparent border around each image
+    const int MIP_LEVELS = 3;   // Short enough that PADDING still separates neighbours at the last level
+    const int SLOT_ALIGN = 1 << (MIP_LEVELS - 1); // Slots line up with texels on every level
+    const uint32_t PLACEHOLDER_KEY = 0xFFFFFFFEu; // Region drawn while an emoji is still loading
+
+    // Packs an image into the atlas under the given key (the emoji id, one per hexcode).
+    // mipChain holds MIP_LEVELS levels of premultiplied RGBA8 in the BuildMipChain() layout;
+    // the levels are uploaded as they are, the atlas never generates mipmaps itself.
+    // Returns false when every page is full.
+    bool Insert(uint32_t key, const unsigned char* mipChain, int width, int height, AtlasRegion& outRegion);
+    const AtlasRegion* Find(uint32_t key);
+    void Remove(uint32_t key);
+    size_t GetRegionBytes(const AtlasRegion& region); // GPU bytes used by the slot, padding and mips included
+    const AtlasRegion& GetPlaceholder(); // Created on first use
+    void Clear();                // Frees all regions but keeps the pages allocated
+
+    // Between these calls Insert() writes into a mapped pixel buffer object and the
+    // texture updates are issued together, so the copy into GPU memory is asynchronous.
+    // Images that do not fit into maxBytes fall back to a direct upload.
+    void BeginUploadBatch(size_t maxBytes);
+    void EndUploadBatch();
+    int GetPageCount();
+    void Shutdown();             // Deletes the page textures
+}
@@ -0,0 +1,335 @@
+#include "EmojiIndex.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+bool EmojiIndex::open(const unsigned char* data, size_t size)
+{
+    close();
+    if (!data || size < sizeof(EmojiIndexHeader)) return false;
+
+    const auto* candidate = reinterpret_cast<const EmojiIndexHeader*>(data);
+    if (candidate->magic != EMOJI_INDEX_MAGIC || candidate->version != EMOJI_INDEX_VERSION) return false;
+
+    // Every section must lie inside the image before anything is dereferenced
+    uint64_t records = candidate->recordCount;
+    auto sectionFits = [size](uint64_t offset, uint64_t bytes) { return offset % 8 == 0 && offset + bytes <= size; };
+    if (!sectionFits(candidate->textOffsetsOffset, records * EMOJI_TEXT_FIELD_COUNT * sizeof(uint32_t)) ||
+        !sectionFits(candidate->textLengthsOffset, records * EMOJI_TEXT_FIELD_COUNT * sizeof(uint16_t)) ||
+        !sectionFits(candidate->groupIdsOffset, records * sizeof(uint16_t)) ||
+        !sectionFits(candidate->subgroupIdsOffset, records * sizeof(uint16_t)) ||
+        !sectionFits(candidate->codepointStartsOffset, (records + 1) * sizeof(uint32_t)) ||
+        !sectionFits(candidate->codepointsOffset, uint64_t(candidate->codepointCount) * sizeof(uint32_t)) ||
+        !sectionFits(candidate->categoriesOffset, uint64_t(candidate->categoryCount) * sizeof(EmojiIndexCategory)) ||
+        !sectionFits(candidate->subgroupsOffset, uint64_t(candidate->subgroupCount) * sizeof(EmojiStringRef)) ||
+        !sectionFits(candidate->hashOffset, uint64_t(candidate->hashBucketCount) * sizeof(uint32_t)) ||
+        !sectionFits(candidate->stringsOffset, candidate->stringsSize)) {
+        return false;
+    }
+    if (candidate->hashBucketCount == 0 || (candidate->hashBucketCount & (candidate->hashBucketCount - 1)) != 0) return false;
+
+    header = candidate;
+    textOffsets = reinterpret_cast<const uint32_t*>(data + header->textOffsetsOffset);
+    textLengths = reinterpret_cast<const uint16_t*>(data + header->textLengthsOffset);
+    groupIds = reinterpret_cast<const uint16_t*>(data + header->groupIdsOffset);
+    subgroupIds = reinterpret_cast<const uint16_t*>(data + header->subgroupIdsOffset);
+    codepointStarts = reinterpret_cast<const uint32_t*>(data + header->codepointStartsOffset);
+    codepointValues = reinterpret_cast<const uint32_t*>(data + header->codepointsOffset);
+    categories = reinterpret_cast<const EmojiIndexCategory*>(data + header->categoriesOffset);
+    subgroups = reinterpret_cast<const EmojiStringRef*>(data + header->subgroupsOffset);
+    buckets = reinterpret_cast<const uint32_t*>(data + header->hashOffset);
+    strings = reinterpret_cast<const char*>(data + header->stringsOffset);
+    imageSize = size;
+    return true;
+}
+
+void EmojiIndex::close()
+{
+    header = nullptr;
+    textOffsets = nullptr;
+    textLengths = nullptr;
+    groupIds = nullptr;
+    subgroupIds = nullptr;
+    codepointStarts = nullptr;
+    codepointValues = nullptr;
+    categories = nullptr;
+    subgroups = nullptr;
+    buckets = nullptr;
+    strings = nullptr;
+    imageSize = 0;
+}
+
+bool EmojiIndex::matchesSource(uint64_t sourceSize, int64_t sourceTime) const
+{
+    return header && header->sourceSize == sourceSize && header->sourceTime == sourceTime;
+}
+
+uint32_t EmojiIndex::find(std::string_view shortcode) const
+{
+    if (!header) return EMOJI_INDEX_EMPTY_BUCKET;
+
+    uint32_t mask = header->hashBucketCount - 1;
+    for (uint32_t slot = EmojiIndexBuilder::HashShortcode(shortcode) & mask;; slot = (slot + 1) & mask) {
+        uint32_t id = buckets[slot];
+        if (id == EMOJI_INDEX_EMPTY_BUCKET) return EMOJI_INDEX_EMPTY_BUCKET;
+        if (text(EMOJI_TEXT_SHORTCODE, id) == shortcode) return id;
+    }
+}
+
+EmojiIndexSectionSizes EmojiIndex::sectionSizes() const
+{
+    EmojiIndexSectionSizes sizes{};
+    if (!header) return sizes;
+
+    size_t records = header->recordCount;
+    sizes.text = records * EMOJI_TEXT_FIELD_COUNT * (sizeof(uint32_t) + sizeof(uint16_t));
+    sizes.ids = records * 2 * sizeof(uint16_t);
+    sizes.codepoints = (records + 1 + header->codepointCount) * sizeof(uint32_t);
+    sizes.tables = header->categoryCount * sizeof(EmojiIndexCategory) + header->subgroupCount * sizeof(EmojiStringRef);
+    sizes.hash = header->hashBucketCount * sizeof(uint32_t);
+    sizes.strings = header->stringsSize;
+    return sizes;
+}
+
+namespace EmojiIndexBuilder {
+    uint32_t HashShortcode(std::string_view shortcode)
+    {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (unsigned char c : shortcode) {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    bool GetSourceStamp(const std::string& jsonFilePath, uint64_t& outSize, int64_t& outTime)
+    {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(jsonFilePath, ec);
+        if (ec) return false;
+        auto time = std::filesystem::last_write_time(jsonFilePath, ec);
+        if (ec) return false;
+
+        outSize = static_cast<uint64_t>(size);
+        outTime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    // Deduplicating string table; group and subgroup names repeat thousands of times
+    class StringTable {
+    public:
+        EmojiStringRef add(const std::string& value)
+        {
+            auto it = offsets.find(value);
+            if (it != offsets.end()) return it->second;
+
+            EmojiStringRef ref{static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(value.size())};
+            bytes.insert(bytes.end(), value.begin(), value.end());
+            bytes.push_back('\0');
+            offsets.emplace(value, ref);
+            return ref;
+        }
+
+        const std::vector<char>& data() const { return bytes; }
+
+    private:
+        std::vector<char> bytes;
+        std::unordered_map<std::string, EmojiStringRef> offsets;
+    };
+
+    template <typename T>
+    static void AppendBytes(std::vector<unsigned char>& image, const T* items, size_t count)
+    {
+        const auto* begin = reinterpret_cast<const unsigned char*>(items);
+        image.insert(image.end(), begin, begin + count * sizeof(T));
+    }
+
+    // Pads the image to 8 bytes, appends the items and returns their offset
+    template <typename T>
+    static uint32_t AppendSection(std::vector<unsigned char>& image, const std::vector<T>& items)
+    {
+        image.resize((image.size() + 7) & ~size_t(7), 0);
+        uint32_t offset = static_cast<uint32_t>(image.size());
+        AppendBytes(image, items.data(), items.size());
+        return offset;
+    }
+
+    bool BuildFromJson(const std::string& jsonFilePath, std::vector<unsigned char>& outImage, std::string& outError)
+    {
+        std::ifstream file(jsonFilePath);
+        if (!file.is_open()) {
+            outError = "failed to open " + jsonFilePath;
+            return false;
+        }
+
+        nlohmann::json jsonData;
+        try {
+            file >> jsonData;
+        } catch (const std::exception& e) {
+            outError = e.what();
+            return false;
+        }
+
+        struct PendingRecord {
+            EmojiStringRef text[EMOJI_TEXT_FIELD_COUNT];
+            uint16_t groupId;
+            uint16_t subgroupId;
+            std::vector<uint32_t> codepoints;
+        };
+
+        StringTable strings;
+        std::vector<PendingRecord> pending;
+        std::vector<std::string> groupNames;
+        std::vector<std::string> subgroupNames;
+        std::unordered_map<std::string, uint16_t> groupLookup;
+        std::unordered_map<std::string, uint16_t> subgroupLookup;
+
+        // Interns a name into a small id table; ids are assigned in order of first appearance
+        auto intern = [](std::unordered_map<std::string, uint16_t>& lookup, std::vector<std::string>& names, const std::string& name) {
+            auto [it, isNew] = lookup.emplace(name, static_cast<uint16_t>(names.size()));
+            if (isNew) names.push_back(name);
+            return it->second;
+        };
+
+        for (const auto& emojiEntry : jsonData) {
+            if (!emojiEntry.contains("hexcode") || !emojiEntry.contains("annotation")) continue;
+
+            std::string hexcode = emojiEntry.value("hexcode", "");
+            std::string annotation = emojiEntry.value("annotation", "");
+
+            // Generate shortcut name by replacing spaces with underscores in annotation
+            std::string shortcutName = ":" + annotation;
+            std::replace(shortcutName.begin(), shortcutName.end(), ' ', '_');
+            shortcutName += ":";
+
+            PendingRecord entry;
+            entry.text[EMOJI_TEXT_EMOJI] = strings.add(emojiEntry.value("emoji", ""));
+            entry.text[EMOJI_TEXT_HEXCODE] = strings.add(hexcode);
+            entry.text[EMOJI_TEXT_ANNOTATION] = strings.add(annotation);
+            entry.text[EMOJI_TEXT_TAGS] = strings.add(emojiEntry.value("tags", ""));
+            entry.text[EMOJI_TEXT_SHORTCODE] = strings.add(shortcutName);
+            entry.groupId = intern(groupLookup, groupNames, emojiEntry.value("group", ""));
+            entry.subgroupId = intern(subgroupLookup, subgroupNames, emojiEntry.value("subgroups", ""));
+
+            for (const EmojiStringRef& ref : entry.text) {
+                if (ref.length > 0xFFFF) {
+                    outError = "string too long in emoji " + hexcode;
+                    return false;
+                }
+            }
+
+            // "1F468-200D-1F469" -> 0x1F468, 0x200D, 0x1F469
+            for (size_t start = 0; start < hexcode.size();) {
+                size_t dash = hexcode.find('-', start);
+                if (dash == std::string::npos) dash = hexcode.size();
+                entry.codepoints.push_back(static_cast<uint32_t>(std::strtoul(hexcode.substr(start, dash - start).c_str(), nullptr, 16)));
+                start = dash + 1;
+            }
+
+            pending.push_back(std::move(entry));
+        }
+
+        if (groupNames.size() > 0xFFFF || subgroupNames.size() > 0xFFFF) {
+            outError = "too many groups or subgroups";
+            return false;
+        }
+
+        // Group records by category (in order of first appearance) so categories are plain ranges
+        std::stable_sort(pending.begin(), pending.end(), [](const PendingRecord& a, const PendingRecord& b) {
+            return a.groupId < b.groupId;
+        });
+
+        uint32_t recordCount = static_cast<uint32_t>(pending.size());
+        std::vector<uint32_t> textOffsets(static_cast<size_t>(recordCount) * EMOJI_TEXT_FIELD_COUNT);
+        std::vector<uint16_t> textLengths(textOffsets.size());
+        std::vector<uint16_t> groupIds(recordCount);
+        std::vector<uint16_t> subgroupIds(recordCount);
+        std::vector<uint32_t> codepointStarts;
+        std::vector<uint32_t> codepoints;
+        codepointStarts.reserve(recordCount + 1);
+
+        std::vector<EmojiIndexCategory> categories(groupNames.size());
+        for (size_t i = 0; i < groupNames.size(); ++i) {
+            categories[i].name = strings.add(groupNames[i]);
+            categories[i].firstRecord = 0;
+            categories[i].recordCount = 0;
+        }
+        std::vector<EmojiStringRef> subgroups;
+        subgroups.reserve(subgroupNames.size());
+        for (const std::string& name : subgroupNames) {
+            subgroups.push_back(strings.add(name));
+        }
+
+        for (uint32_t id = 0; id < recordCount; ++id) {
+            const PendingRecord& entry = pending[id];
+            for (uint32_t field = 0; field < EMOJI_TEXT_FIELD_COUNT; ++field) {
+                textOffsets[field * recordCount + id] = entry.text[field].offset;
+                textLengths[field * recordCount + id] = static_cast<uint16_t>(entry.text[field].length);
+            }
+            groupIds[id] = entry.groupId;
+            subgroupIds[id] = entry.subgroupId;
+            codepointStarts.push_back(static_cast<uint32_t>(codepoints.size()));
+            codepoints.insert(codepoints.end(), entry.codepoints.begin(), entry.codepoints.end());
+
+            EmojiIndexCategory& category = categories[entry.groupId];
+            if (category.recordCount == 0) category.firstRecord = id;
+            category.recordCount++;
+        }
+        codepointStarts.push_back(static_cast<uint32_t>(codepoints.size()));
+
+        // Open addressing table at <= 50% load. Duplicate shortcodes resolve to the
+        // last record, matching the old name map behaviour.
+        uint32_t bucketCount = 16;
+        while (bucketCount < recordCount * 2) bucketCount <<= 1;
+        std::vector<uint32_t> buckets(bucketCount, EMOJI_INDEX_EMPTY_BUCKET);
+        const std::vector<char>& stringBytes = strings.data();
+        auto shortcodeOf = [&](uint32_t id) {
+            size_t column = static_cast<size_t>(EMOJI_TEXT_SHORTCODE) * recordCount + id;
+            return std::string_view(stringBytes.data() + textOffsets[column], textLengths[column]);
+        };
+        for (uint32_t id = 0; id < recordCount; ++id) {
+            std::string_view shortcode = shortcodeOf(id);
+            uint32_t slot = HashShortcode(shortcode) & (bucketCount - 1);
+            while (buckets[slot] != EMOJI_INDEX_EMPTY_BUCKET && shortcodeOf(buckets[slot]) != shortcode) {
+                slot = (slot + 1) & (bucketCount - 1);
+            }
+            buckets[slot] = id;
+        }
+
+        EmojiIndexHeader header{};
+        header.magic = EMOJI_INDEX_MAGIC;
+        header.version = EMOJI_INDEX_VERSION;
+        if (!GetSourceStamp(jsonFilePath, header.sourceSize, header.sourceTime)) {
+            outError = "failed to stat " + jsonFilePath;
+            return false;
+        }
+        header.recordCount = recordCount;
+        header.categoryCount = static_cast<uint32_t>(categories.size());
+        header.subgroupCount = static_cast<uint32_t>(subgroups.size());
+        header.codepointCount = static_cast<uint32_t>(codepoints.size());
+        header.hashBucketCount = bucketCount;
+
+        outImage.clear();
+        AppendBytes(outImage, &header, 1);
+        header.textOffsetsOffset = AppendSection(outImage, textOffsets);
+        header.textLengthsOffset = AppendSection(outImage, textLengths);
+        header.groupIdsOffset = AppendSection(outImage, groupIds);
+        header.subgroupIdsOffset = AppendSection(outImage, subgroupIds);
+        header.codepointStartsOffset = AppendSection(outImage, codepointStarts);
+        header.codepointsOffset = AppendSection(outImage, codepoints);
+        header.categoriesOffset = AppendSection(outImage, categories);
+        header.subgroupsOffset = AppendSection(outImage, subgroups);
+        header.hashOffset = AppendSection(outImage, buckets);
+        header.stringsOffset = AppendSection(outImage, stringBytes);
+        header.stringsSize = static_cast<uint32_t>(stringBytes.size());
+
+        // The section offsets are only known now
+        std::memcpy(outImage.data(), &header, sizeof(header));
+        return true;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Binary emoji metadata index, baked from openmoji.json by emoji_index_baker.
+//
+// Records are stored as columns rather than structs, so a pass that only needs
+// shortcodes (search, lookup) touches only the shortcode column. Group and
+// subgroup names are interned once and referenced by id.
+//
+// Layout (all offsets are from the start of the file, native byte order, sections 8-byte aligned):
+//   EmojiIndexHeader
+//   uint32_t           textOffsets[EMOJI_TEXT_FIELD_COUNT][recordCount]  into strings
+//   uint16_t           textLengths[EMOJI_TEXT_FIELD_COUNT][recordCount]  excluding the NUL
+//   uint16_t           groupIds[recordCount]
+//   uint16_t           subgroupIds[recordCount]
+//   uint32_t           codepointStarts[recordCount + 1]                  ranges into codepoints
+//   uint32_t           codepoints[codepointCount]                        parsed from the hexcode
+//   EmojiIndexCategory categories[categoryCount]                         one per group, records are grouped by category
+//   EmojiStringRef     subgroups[subgroupCount]
+//   uint32_t           buckets[hashBucketCount]                          open addressing, shortcode -> record
+//   char               strings[stringsSize]                              interned, NUL-terminated
+//
+// The file is mapped read-only and queried in place, so loading it costs no
+// parsing and no allocation.
+
+const uint32_t EMOJI_INDEX_MAGIC = 0x49534D4C; // "LMSI"
+const uint32_t EMOJI_INDEX_VERSION = 2;
+const uint32_t EMOJI_INDEX_EMPTY_BUCKET = 0xFFFFFFFFu;
+
+// Per-emoji string columns
+enum EmojiTextField : uint32_t {
+    EMOJI_TEXT_EMOJI = 0,
+    EMOJI_TEXT_HEXCODE,
+    EMOJI_TEXT_ANNOTATION,
+    EMOJI_TEXT_TAGS,
+    EMOJI_TEXT_SHORTCODE, // ":annotation_with_underscores:"
+    EMOJI_TEXT_FIELD_COUNT
+};
+
+struct EmojiStringRef {
+    uint32_t offset;
+    uint32_t length; // Excludes the terminating NUL
+};
+
+struct EmojiIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceSize;  // Size of the JSON the index was baked from
+    int64_t sourceTime;   // Last write time of that JSON, used to detect a stale index
+    uint32_t recordCount;
+    uint32_t categoryCount;
+    uint32_t subgroupCount;
+    uint32_t codepointCount;
+    uint32_t hashBucketCount; // Power of two
+    uint32_t textOffsetsOffset;
+    uint32_t textLengthsOffset;
+    uint32_t groupIdsOffset;
+    uint32_t subgroupIdsOffset;
+    uint32_t codepointStartsOffset;
+    uint32_t codepointsOffset;
+    uint32_t categoriesOffset;
+    uint32_t subgroupsOffset;
+    uint32_t hashOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+};
+
+struct EmojiIndexCategory {
+    EmojiStringRef name;
+    uint32_t firstRecord;
+    uint32_t recordCount;
+};
+
+// Bytes taken by each part of an index image
+struct EmojiIndexSectionSizes {
+    size_t text;       // String offset and length columns
+    size_t ids;        // Group and subgroup id columns
+    size_t codepoints; // Codepoint ranges and values
+    size_t tables;     // Category and subgroup tables
+    size_t hash;
+    size_t strings;
+};
+
+// Read-only view over an index image, either memory-mapped or built in memory.
+class EmojiIndex {
+public:
+    // Validates the header and section bounds. The memory must outlive the view.
+    bool open(const unsigned char* data, size_t size);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // True when the index was baked from the JSON file with this size and write time
+    bool matchesSource(uint64_t sourceSize, int64_t sourceTime) const;
+
+    uint32_t recordCount() const { return header ? header->recordCount : 0; }
+    uint32_t categoryCount() const { return header ? header->categoryCount : 0; }
+    uint32_t subgroupCount() const { return header ? header->subgroupCount : 0; }
+
+    std::string_view text(EmojiTextField field, uint32_t id) const
+    {
+        size_t column = static_cast<size_t>(field) * header->recordCount;
+        return std::string_view(strings + textOffsets[column + id], textLengths[column + id]);
+    }
+    uint16_t groupId(uint32_t id) const { return groupIds[id]; }
+    uint16_t subgroupId(uint32_t id) const { return subgroupIds[id]; }
+    const uint32_t* codepoints(uint32_t id, uint32_t& outCount) const
+    {
+        outCount = codepointStarts[id + 1] - codepointStarts[id];
+        return codepointValues + codepointStarts[id];
+    }
+
+    const EmojiIndexCategory& category(uint32_t index) const { return categories[index]; }
+    std::string_view subgroupName(uint16_t subgroupId) const { return string(subgroups[subgroupId]); }
+    std::string_view string(EmojiStringRef ref) const { return std::string_view(strings + ref.offset, ref.length); }
+
+    // Returns the record id for a shortcode, or EMOJI_INDEX_EMPTY_BUCKET if unknown
+    uint32_t find(std::string_view shortcode) const;
+
+    size_t sizeBytes() const { return imageSize; }
+    EmojiIndexSectionSizes sectionSizes() const;
+
+private:
+    const EmojiIndexHeader* header = nullptr;
+    const uint32_t* textOffsets = nullptr;
+    const uint16_t* textLengths = nullptr;
+    const uint16_t* groupIds = nullptr;
+    const uint16_t* subgroupIds = nullptr;
+    const uint32_t* codepointStarts = nullptr;
+    const uint32_t* codepointValues = nullptr;
+    const EmojiIndexCategory* categories = nullptr;
+    const EmojiStringRef* subgroups = nullptr;
+    const uint32_t* buckets = nullptr;
+    const char* strings = nullptr;
+    size_t imageSize = 0;
+};
+
+namespace EmojiIndexBuilder {
+    // Parses openmoji.json and serializes it into the index layout above.
+    bool BuildFromJson(const std::string& jsonFilePath, std::vector<unsigned char>& outImage, std::string& outError);
+
+    // Size and write time of the JSON file, as stored in the index header
+    bool GetSourceStamp(const std::string& jsonFilePath, uint64_t& outSize, int64_t& outTime);
+
+    uint32_t HashShortcode(std::string_view shortcode);
+}
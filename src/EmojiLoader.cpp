@@ -0,0 +1,211 @@
+#include "EmojiLoader.h"
+#include "utils/image.h"
+#include "utils/ImageOps.h"
+#include "debug/GLogMacros.h"
+#include "debug/GTrace.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace EmojiLoader {
+    const uint8_t NOT_QUEUED = 0xFF;
+
+    struct DecodeRequest {
+        uint32_t emojiId;
+        std::string filePath;
+    };
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<DecodeRequest> visibleQueue;
+    std::deque<DecodeRequest> prefetchQueue;
+    std::vector<uint8_t> queuedPriority; // Per emoji id, NOT_QUEUED or the priority it is queued at
+    bool stopWorkers = false;
+
+    std::mutex completedMutex;
+    std::vector<DecodedEmoji> completed;
+
+    std::vector<std::thread> workers;
+    std::atomic<bool> running(false);
+    std::atomic<CompletedCallback> onCompleted(nullptr);
+    int decodeTargetSize = 0;
+    int decodeMipCount = 1;
+
+    // Visible requests are served newest first: while scrolling, the most recent
+    // requests are the ones still on screen. Prefetches keep their order.
+    static bool PopRequest(DecodeRequest& out)
+    {
+        while (!visibleQueue.empty()) {
+            out = std::move(visibleQueue.back());
+            visibleQueue.pop_back();
+            if (queuedPriority[out.emojiId] == static_cast<uint8_t>(EmojiLoadPriority::Visible)) {
+                queuedPriority[out.emojiId] = NOT_QUEUED;
+                return true;
+            }
+        }
+        while (!prefetchQueue.empty()) {
+            out = std::move(prefetchQueue.front());
+            prefetchQueue.pop_front();
+            // Skip entries that were promoted to the visible queue (and already decoded from there)
+            if (queuedPriority[out.emojiId] == static_cast<uint8_t>(EmojiLoadPriority::Prefetch)) {
+                queuedPriority[out.emojiId] = NOT_QUEUED;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Same processing the pack baker applies: premultiply, reduce to the display size, build the mips
+    static void DecodeImage(const std::string& filePath, DecodedEmoji& out)
+    {
+        int width, height;
+        unsigned char* source = LoadImageData(filePath.c_str(), &width, &height);
+        if (!source) return;
+        PremultiplyAlpha(source, width, height);
+
+        float scale = decodeTargetSize > 0 ? std::min(1.0f, static_cast<float>(decodeTargetSize) / std::max(width, height)) : 1.0f;
+        out.width = std::max(1, static_cast<int>(width * scale + 0.5f));
+        out.height = std::max(1, static_cast<int>(height * scale + 0.5f));
+
+        std::vector<unsigned char> resized;
+        const unsigned char* levelZero = source;
+        if (out.width != width || out.height != height) {
+            resized.resize(static_cast<size_t>(out.width) * out.height * 4);
+            ResizeImageArea(source, width, height, resized.data(), out.width, out.height);
+            levelZero = resized.data();
+        }
+
+        out.pixels.resize(GetMipChainBytes(out.width, out.height, decodeMipCount));
+        BuildMipChain(levelZero, out.width, out.height, decodeMipCount, out.pixels.data());
+        FreeImageData(source);
+    }
+
+    static void WorkerLoop()
+    {
+        GTrace::setThreadName("EmojiLoader");
+        while (true) {
+            DecodeRequest request;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [] { return stopWorkers || !visibleQueue.empty() || !prefetchQueue.empty(); });
+                if (stopWorkers) return;
+                if (!PopRequest(request)) continue;
+            }
+
+            DecodedEmoji result;
+            result.emojiId = request.emojiId;
+            {
+                TRACE_SCOPE("EmojiLoader::DecodeImage");
+                DecodeImage(request.filePath, result);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back(std::move(result));
+            }
+            if (CompletedCallback callback = onCompleted.load(std::memory_order_acquire)) callback();
+        }
+    }
+
+    void Start(uint32_t emojiCount, int targetSize, int mipCount, unsigned workerCount)
+    {
+        if (running.load()) return;
+        decodeTargetSize = targetSize;
+        decodeMipCount = mipCount;
+
+        if (workerCount == 0) {
+            // Leave the render thread and the logger a core each
+            unsigned hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = std::clamp(hardwareThreads > 2 ? hardwareThreads - 2 : 1u, 1u, 4u);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queuedPriority.assign(emojiCount, NOT_QUEUED);
+            stopWorkers = false;
+        }
+
+        for (unsigned i = 0; i < workerCount; ++i) {
+            workers.emplace_back(WorkerLoop);
+        }
+        running.store(true);
+        GLOG_INFO("Emoji loader started with {} worker threads.", workerCount);
+    }
+
+    void Stop()
+    {
+        if (!running.load()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopWorkers = true;
+            visibleQueue.clear();
+            prefetchQueue.clear();
+        }
+        queueCondition.notify_all();
+
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+        workers.clear();
+
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completed.clear();
+        running.store(false);
+    }
+
+    bool IsRunning()
+    {
+        return running.load();
+    }
+
+    void Request(uint32_t emojiId, const std::string& filePath, EmojiLoadPriority priority)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (emojiId >= queuedPriority.size()) return;
+
+            uint8_t current = queuedPriority[emojiId];
+            uint8_t requested = static_cast<uint8_t>(priority);
+            if (current != NOT_QUEUED && current <= requested) return; // Already queued at this priority or higher
+
+            queuedPriority[emojiId] = requested;
+            if (priority == EmojiLoadPriority::Visible) {
+                visibleQueue.push_back(DecodeRequest{emojiId, filePath});
+            } else {
+                prefetchQueue.push_back(DecodeRequest{emojiId, filePath});
+            }
+        }
+        queueCondition.notify_one();
+    }
+
+    void TakeCompleted(size_t maxBytes, std::vector<DecodedEmoji>& out)
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+
+        size_t taken = 0;
+        size_t bytes = 0;
+        while (taken < completed.size()) {
+            size_t imageBytes = completed[taken].pixels.size();
+            if (taken > 0 && bytes + imageBytes > maxBytes) break;
+            bytes += imageBytes;
+            out.push_back(std::move(completed[taken]));
+            taken++;
+        }
+        completed.erase(completed.begin(), completed.begin() + taken);
+    }
+
+    void SetCompletedCallback(CompletedCallback callback)
+    {
+        onCompleted.store(callback, std::memory_order_release);
+    }
+
+    size_t GetQueuedCount()
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return visibleQueue.size() + prefetchQueue.size();
+    }
+}
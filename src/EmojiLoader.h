@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class EmojiLoadPriority : uint8_t {
+    Visible = 0,  // On screen this frame
+    Prefetch = 1  // Likely to be needed soon
+};
+
+// An image decoded by a worker thread, waiting to be uploaded on the GL thread.
+// pixels is empty if the file could not be decoded.
+struct DecodedEmoji {
+    uint32_t emojiId = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels; // Premultiplied mip chain, see BuildMipChain()
+};
+
+// Background decoding of emoji images. Requests go into a two-level priority
+// queue serviced by worker threads; finished images are handed back to the GL
+// thread, which uploads a bounded number of bytes per frame.
+namespace EmojiLoader {
+    // Decoded images are reduced to targetSize (0 keeps them as they are) and get mipCount levels
+    void Start(uint32_t emojiCount, int targetSize, int mipCount, unsigned workerCount = 0); // 0 picks a count from the hardware
+    void Stop();                                               // Joins the workers and frees pending results
+    bool IsRunning();
+
+    // Queues a decode. Re-requesting a queued id with a higher priority promotes it.
+    void Request(uint32_t emojiId, const std::string& filePath, EmojiLoadPriority priority);
+
+    // Moves finished decodes into out until about maxBytes of pixels were taken.
+    // At least one image is returned if any is ready, so large images cannot stall the queue.
+    void TakeCompleted(size_t maxBytes, std::vector<DecodedEmoji>& out);
+
+    // Called on a worker thread after each decode lands in the completed list, e.g. to wake the render loop
+    using CompletedCallback = void (*)();
+    void SetCompletedCallback(CompletedCallback callback);
+
+    size_t GetQueuedCount();
+}
@@ -1,142 +1,468 @@
 #include "utils/image.h"
+#include "utils/MappedFile.h"
+#include "utils/ImageOps.h"
 #include "EmojiManager.h"
+#include "EmojiIndex.h"
+#include "EmojiPack.h"
+#include "TextureResidency.h"
+#include "EmojiLoader.h"
+#include "MessageLayout.h"
+#include "EmojiSearch.h"
+#include "EmojiUsage.h"
 #include "debug/GLogMacros.h"
-#include <nlohmann/json.hpp>
-#include <fstream>
-#include <regex>
+#include "debug/GTrace.h"
+#include "debug/GMetrics.h"
+#include <algorithm>
 #include <filesystem>
+#include <vector>
 
 namespace EmojiManager {
-    const size_t MAX_TEXTURE_CACHE_SIZE = 100; // Limit the number of cached textures
-    std::list<std::string> textureUsageOrder; // Track usage order for LRU
-    std::unordered_map<std::string, std::vector<EmojiMetadata>> emojiCategories;
-    std::unordered_map<std::string, GLuint> emojiTextureCache;
-    std::unordered_map<std::string, std::string> emojiNameMap; // Map for :name: to hexcode
+    const size_t TEXTURE_BUDGET_BYTES = 24 * 1024 * 1024; // GPU bytes of atlas slots kept resident
+    const uint32_t TEXTURE_MIN_IDLE_FRAMES = 120;         // Frames an emoji must go unused before it can be evicted
+    const size_t UPLOAD_BUDGET_BYTES = 512 * 1024;        // Decoded pixels uploaded to the atlas per frame
+    const int EMOJI_DRAW_SIZE = 24;                       // Largest size the UI draws an emoji at, in points
+    static_assert(EmojiAtlas::MIP_LEVELS == EMOJI_PACK_MIP_COUNT, "Pack and atlas must agree on the mip chain");
+    TextureResidency textureResidency;
 
-    void LoadEmojiMetadata(const std::string& jsonFilePath)
+    // Load state of emojis that are not resident; resident ones are tracked by textureResidency
+    enum class TextureLoadState : uint8_t { Unloaded, PendingPrefetch, PendingVisible, Failed };
+    std::vector<TextureLoadState> textureLoadStates;
+    std::vector<DecodedEmoji> decodedScratch; // Reused every frame to collect finished decodes
+
+    // Pre-decoded images; when present, misses are copied straight from the mapping
+    // and the PNG loader is only used for emojis the pack does not have
+    EmojiPack emojiPack;
+    uint32_t emojiPackTier = 0;
+    float displayScale = 1.0f;
+    std::vector<uint32_t> packVisibleUploads;  // Emoji ids waiting for EndFrame()
+    std::vector<uint32_t> packPrefetchUploads;
+    RedrawCallback redrawCallback = nullptr;
+    std::vector<uint32_t> pinnedEmojis; // The frequent set, pinned again after every residency reset
+    uint32_t metadataGeneration = 0;
+
+    EmojiIndex emojiIndex;
+    MappedFile emojiIndexFile;                    // Backing storage when the baked index is used
+    std::vector<unsigned char> emojiIndexFallback; // Backing storage when the index is rebuilt from JSON
+
+    static void EvictEmojiTexture(uint32_t emojiId)
+    {
+        EmojiAtlas::Remove(emojiId);
+        textureLoadStates[emojiId] = TextureLoadState::Unloaded;
+    }
+
+    static void ResetTextureResidency()
+    {
+        EmojiLoader::Stop();
+        EmojiAtlas::Clear();
+        packVisibleUploads.clear();
+        packPrefetchUploads.clear();
+        textureLoadStates.assign(emojiIndex.recordCount(), TextureLoadState::Unloaded);
+        textureResidency.reset(emojiIndex.recordCount());
+        textureResidency.setBudget(TEXTURE_BUDGET_BYTES);
+        textureResidency.setMinIdleFrames(TEXTURE_MIN_IDLE_FRAMES);
+        textureResidency.setEvictCallback(EvictEmojiTexture);
+        for (uint32_t emojiId : pinnedEmojis) {
+            textureResidency.pin(emojiId);
+        }
+    }
+
+    static std::string GetIndexPath(const std::string& jsonFilePath)
+    {
+        return std::filesystem::path(jsonFilePath).replace_extension(".idx").string();
+    }
+
+    // Texels an emoji needs to stay sharp at the current display scale
+    static int GetEmojiPixelSize()
+    {
+        return static_cast<int>(EMOJI_DRAW_SIZE * displayScale + 0.5f);
+    }
+
+    static void OpenEmojiPack(const std::string& jsonFilePath)
     {
-        std::ifstream file(jsonFilePath);
-        if (!file.is_open()) {
-            GLOG_ERROR("Failed to open emoji metadata file: {}", jsonFilePath);
+        emojiPack.close();
+        std::string packPath = std::filesystem::path(jsonFilePath).replace_extension(".pack").string();
+        if (!emojiPack.open(packPath)) {
+            GLOG_WARN("Emoji pack not found or invalid, decoding PNGs instead: {}", packPath);
             return;
         }
 
-        try {
-            nlohmann::json jsonData;
-            file >> jsonData;
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+        EmojiIndexBuilder::GetSourceStamp(jsonFilePath, sourceSize, sourceTime);
+        if (!emojiPack.matchesIndex(sourceSize, sourceTime, emojiIndex.recordCount(), EmojiAtlas::MIP_LEVELS)) {
+            GLOG_WARN("Emoji pack is stale, decoding PNGs instead: {}", packPath);
+            emojiPack.close();
+            return;
+        }
 
-            for (const auto& emojiEntry : jsonData) {
-                if (emojiEntry.contains("hexcode") && emojiEntry.contains("annotation")) {
-                    EmojiMetadata metadata;
-                    metadata.emoji = emojiEntry.value("emoji", "");
-                    metadata.hexcode = emojiEntry.value("hexcode", "");
-                    metadata.group = emojiEntry.value("group", "");
-                    metadata.subgroups = emojiEntry.value("subgroups", "");
-                    metadata.annotation = emojiEntry.value("annotation", "");
-                    metadata.tags = emojiEntry.value("tags", "");
+        emojiPackTier = emojiPack.selectTier(static_cast<uint32_t>(GetEmojiPixelSize()));
+        GLOG_INFO("Mapped emoji pack: {} tiers, using {} px.", emojiPack.tierCount(), emojiPack.tierSize(emojiPackTier));
+    }
 
-                    // Generate shortcut name by replacing spaces with underscores in annotation
-                    std::string shortcutName = ":" + metadata.annotation;
-                    std::replace(shortcutName.begin(), shortcutName.end(), ' ', '_');
-                    shortcutName += ":";
+    static bool OpenBakedIndex(const std::string& jsonFilePath)
+    {
+        std::string indexPath = GetIndexPath(jsonFilePath);
+        if (!emojiIndexFile.open(indexPath)) {
+            GLOG_WARN("Emoji index not found: {}", indexPath);
+            return false;
+        }
 
-                    // Add to emoji categories
-                    emojiCategories[metadata.group].push_back(metadata);
+        if (!emojiIndex.open(emojiIndexFile.data(), emojiIndexFile.size())) {
+            GLOG_WARN("Emoji index is corrupt or from another version: {}", indexPath);
+            emojiIndexFile.close();
+            return false;
+        }
 
-                    // Map shortcut name to hexcode for image loading
-                    emojiNameMap[shortcutName] = metadata.hexcode;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        if (EmojiIndexBuilder::GetSourceStamp(jsonFilePath, sourceSize, sourceTime) &&
+            !emojiIndex.matchesSource(sourceSize, sourceTime)) {
+            GLOG_WARN("Emoji index is stale: {}", indexPath);
+            emojiIndex.close();
+            emojiIndexFile.close();
+            return false;
+        }
 
-                    // Debug log for each emoji added
-                    GLOG_DEBUG("Added emoji: {} -> {}", shortcutName, metadata.hexcode);
-                }
-            }
+        return true;
+    }
 
-            GLOG_INFO("Loaded {} emoji categories and {} emoji names.", emojiCategories.size(), emojiNameMap.size());
-        } catch (const std::exception& e) {
-            GLOG_ERROR("Error parsing emoji metadata: {}", e.what());
+    void LoadEmojiMetadata(const std::string& jsonFilePath)
+    {
+        TRACE_SCOPE("EmojiManager::LoadEmojiMetadata");
+        emojiIndex.close();
+        emojiIndexFile.close();
+        emojiIndexFallback.clear();
+        pinnedEmojis.clear(); // Ids of the previous index
+        metadataGeneration++;
+
+        if (OpenBakedIndex(jsonFilePath)) {
+            GLOG_INFO("Mapped emoji index: {} emojis in {} categories.", emojiIndex.recordCount(), emojiIndex.categoryCount());
+            OpenEmojiPack(jsonFilePath);
+            ResetTextureResidency();
+            return;
         }
+
+        // Fall back to parsing the JSON into the same layout in memory
+        std::string error;
+        if (!EmojiIndexBuilder::BuildFromJson(jsonFilePath, emojiIndexFallback, error) ||
+            !emojiIndex.open(emojiIndexFallback.data(), emojiIndexFallback.size())) {
+            GLOG_ERROR("Error loading emoji metadata from {}: {}", jsonFilePath, error);
+            emojiIndexFallback.clear();
+            return;
+        }
+
+        GLOG_INFO("Loaded {} emoji categories and {} emoji names from JSON.", emojiIndex.categoryCount(), emojiIndex.recordCount());
+        OpenEmojiPack(jsonFilePath);
+        ResetTextureResidency();
     }
 
-    GLuint GetEmojiTexture(const std::string& shortcode)
+    uint32_t GetMetadataGeneration()
     {
-        if (emojiTextureCache.count(shortcode)) {
-            // Move the accessed texture to the front of the usage order
-            textureUsageOrder.remove(shortcode);
-            textureUsageOrder.push_front(shortcode);
-            return emojiTextureCache[shortcode];
+        return metadataGeneration;
+    }
+
+    void SetDisplayScale(float scale)
+    {
+        if (scale <= 0.0f || scale == displayScale) return;
+        displayScale = scale;
+
+        // Switch to the images baked for this scale; what is resident was sized for the old one
+        uint32_t tier = emojiPack.isOpen() ? emojiPack.selectTier(static_cast<uint32_t>(GetEmojiPixelSize())) : 0;
+        if (!emojiPack.isOpen() || tier != emojiPackTier) {
+            emojiPackTier = tier;
+            ResetTextureResidency();
         }
+        GLOG_INFO("Emoji display scale set to {}.", scale);
+    }
+
+    uint32_t GetEmojiCount()
+    {
+        return emojiIndex.recordCount();
+    }
+
+    EmojiMetadata GetEmoji(uint32_t emojiId)
+    {
+        EmojiMetadata metadata;
+        metadata.emoji = emojiIndex.text(EMOJI_TEXT_EMOJI, emojiId);
+        metadata.hexcode = emojiIndex.text(EMOJI_TEXT_HEXCODE, emojiId);
+        metadata.annotation = emojiIndex.text(EMOJI_TEXT_ANNOTATION, emojiId);
+        metadata.tags = emojiIndex.text(EMOJI_TEXT_TAGS, emojiId);
+        metadata.shortcode = emojiIndex.text(EMOJI_TEXT_SHORTCODE, emojiId);
+        metadata.groupId = emojiIndex.groupId(emojiId);
+        metadata.subgroupId = emojiIndex.subgroupId(emojiId);
+        metadata.group = emojiIndex.string(emojiIndex.category(metadata.groupId).name);
+        metadata.subgroups = emojiIndex.subgroupName(metadata.subgroupId);
+        return metadata;
+    }
 
-        // Retrieve the hexcode from the emojiNameMap
-        if (!emojiNameMap.count(shortcode)) {
+    std::string_view GetEmojiShortcode(uint32_t emojiId)
+    {
+        return emojiIndex.text(EMOJI_TEXT_SHORTCODE, emojiId);
+    }
+
+    const uint32_t* GetEmojiCodepoints(uint32_t emojiId, uint32_t& outCount)
+    {
+        return emojiIndex.codepoints(emojiId, outCount);
+    }
+
+    uint32_t GetCategoryCount()
+    {
+        return emojiIndex.categoryCount();
+    }
+
+    EmojiCategory GetCategory(uint32_t index)
+    {
+        const EmojiIndexCategory& category = emojiIndex.category(index);
+        return EmojiCategory{emojiIndex.string(category.name), category.firstRecord, category.recordCount};
+    }
+
+    uint32_t FindEmoji(std::string_view shortcode)
+    {
+        uint32_t id = emojiIndex.find(shortcode);
+        return id == EMOJI_INDEX_EMPTY_BUCKET ? INVALID_EMOJI_ID : id;
+    }
+
+    EmojiMetadataMemoryReport GetMetadataMemoryReport()
+    {
+        EmojiMetadataMemoryReport report{};
+        report.mapped = emojiIndexFile.isOpen();
+        report.indexBytes = emojiIndex.sizeBytes();
+        report.indexResidentBytes = report.mapped ? emojiIndexFile.residentBytes() : emojiIndexFallback.capacity();
+        report.sections = emojiIndex.sectionSizes();
+        report.textureStateBytes = textureLoadStates.capacity() * sizeof(TextureLoadState) + textureResidency.memoryBytes();
+        report.searchIndexBytes = EmojiSearch::GetMemoryBytes();
+        report.packBytes = emojiPack.isOpen() ? emojiPack.sizeBytes() : 0;
+        report.packResidentBytes = emojiPack.isOpen() ? emojiPack.residentBytes() : 0;
+        report.totalResidentBytes = report.indexResidentBytes + report.textureStateBytes + report.searchIndexBytes + report.packResidentBytes;
+        return report;
+    }
+
+    void LogMetadataMemoryReport()
+    {
+        EmojiMetadataMemoryReport report = GetMetadataMemoryReport();
+        GLOG_INFO("Emoji metadata memory: {} KB resident ({} index of {} KB {} KB resident, texture state {} KB, search {} KB, "
+                  "pack of {} KB {} KB resident).",
+                  report.totalResidentBytes / 1024, report.mapped ? "mapped" : "heap", report.indexBytes / 1024,
+                  report.indexResidentBytes / 1024, report.textureStateBytes / 1024, report.searchIndexBytes / 1024,
+                  report.packBytes / 1024, report.packResidentBytes / 1024);
+        GLOG_INFO("Emoji index sections: text columns {} KB, id columns {} KB, codepoints {} KB, tables {} KB, hash {} KB, strings {} KB.",
+                  report.sections.text / 1024, report.sections.ids / 1024, report.sections.codepoints / 1024,
+                  report.sections.tables / 1024, report.sections.hash / 1024, report.sections.strings / 1024);
+    }
+
+    AtlasRegion GetEmojiTexture(const std::string& shortcode)
+    {
+        // Retrieve the emoji id from the emoji index
+        uint32_t emojiId = FindEmoji(shortcode);
+        if (emojiId == INVALID_EMOJI_ID) {
             GLOG_ERROR("Emoji shortcode not found: {}", shortcode);
-            return 0;
+            return AtlasRegion();
         }
+        return GetEmojiTexture(emojiId);
+    }
 
-        std::string hexcode = emojiNameMap[shortcode];
-        std::transform(hexcode.begin(), hexcode.end(), hexcode.begin(), ::tolower); // Ensure lowercase
-        std::string filePath = "assets/emojis/" + hexcode + ".png";
+    AtlasRegion GetEmojiTexture(uint32_t emojiId, EmojiLoadPriority priority)
+    {
+        if (emojiId >= GetEmojiCount()) return AtlasRegion();
 
-        if (!std::filesystem::exists(filePath)) {
-            GLOG_ERROR("Emoji texture file not found: {}", filePath);
-            return 0;
+        TextureLoadState& state = textureLoadStates[emojiId];
+        if (state == TextureLoadState::Failed) return AtlasRegion();
+        if (textureResidency.touch(emojiId)) {
+            return *EmojiAtlas::Find(emojiId);
         }
+        TRACE_SCOPE("EmojiManager::GetEmojiTexture miss");
 
-        GLuint texID = LoadTextureFromFile(filePath.c_str());
-        if (texID == 0) {
-            GLOG_ERROR("Failed to load texture for: {}", shortcode);
-            return 0;
+        // Queue the upload or decode (or promote an already queued prefetch) and draw the placeholder meanwhile.
+        // Only queuing a load counts as a miss, not every frame an emoji spends pending.
+        if (state == TextureLoadState::Unloaded) textureResidency.countMiss();
+        bool promote = state == TextureLoadState::PendingPrefetch && priority == EmojiLoadPriority::Visible;
+        int packWidth, packHeight;
+        if (state == TextureLoadState::Unloaded && emojiPack.image(emojiPackTier, emojiId, packWidth, packHeight)) {
+            if (priority == EmojiLoadPriority::Visible) packVisibleUploads.push_back(emojiId);
+            else packPrefetchUploads.push_back(emojiId);
+            state = priority == EmojiLoadPriority::Visible ? TextureLoadState::PendingVisible : TextureLoadState::PendingPrefetch;
+        } else if (promote && emojiPack.image(emojiPackTier, emojiId, packWidth, packHeight)) {
+            packVisibleUploads.push_back(emojiId); // Uploaded from here first, the prefetch entry is skipped
+            state = TextureLoadState::PendingVisible;
+        } else if (state == TextureLoadState::Unloaded || promote) {
+            if (!EmojiLoader::IsRunning()) EmojiLoader::Start(GetEmojiCount(), GetEmojiPixelSize(), EmojiAtlas::MIP_LEVELS);
+
+            std::string fileName(GetEmoji(emojiId).hexcode);
+            std::transform(fileName.begin(), fileName.end(), fileName.begin(), ::tolower); // Ensure lowercase
+            EmojiLoader::Request(emojiId, "assets/emojis/" + fileName + ".png", priority);
+            state = priority == EmojiLoadPriority::Visible ? TextureLoadState::PendingVisible : TextureLoadState::PendingPrefetch;
         }
 
-        // Add the texture to the cache
-        emojiTextureCache[shortcode] = texID;
-        textureUsageOrder.push_front(shortcode);
+        return EmojiAtlas::GetPlaceholder();
+    }
 
-        // If the cache exceeds the limit, remove the least recently used texture
-        if (emojiTextureCache.size() > MAX_TEXTURE_CACHE_SIZE) {
-            std::string lru = textureUsageOrder.back();
-            glDeleteTextures(1, &emojiTextureCache[lru]);
-            emojiTextureCache.erase(lru);
-            textureUsageOrder.pop_back();
+    void RequestEmojiTexture(uint32_t emojiId)
+    {
+        if (emojiId >= GetEmojiCount() || textureResidency.isResident(emojiId)) return;
+        if (textureLoadStates[emojiId] != TextureLoadState::Unloaded) return;
+
+        GetEmojiTexture(emojiId, EmojiLoadPriority::Prefetch);
+    }
+
+    // When every atlas page is full, evicts least recently used emojis that were not drawn this frame
+    static void InsertIntoAtlas(uint32_t emojiId, const unsigned char* mipChain, int width, int height)
+    {
+        AtlasRegion region;
+        bool inserted = EmojiAtlas::Insert(emojiId, mipChain, width, height, region);
+        while (!inserted && textureResidency.evictOne()) {
+            inserted = EmojiAtlas::Insert(emojiId, mipChain, width, height, region);
         }
 
-        return texID;
+        if (inserted) {
+            textureResidency.insert(emojiId, EmojiAtlas::GetRegionBytes(region));
+        } else {
+            // Everything resident was drawn this frame; try again later
+            textureLoadStates[emojiId] = TextureLoadState::Unloaded;
+        }
     }
 
-    void ClearUnusedTextures()
+    // Copies queued pack images into the atlas until the byte budget is spent; returns the bytes used
+    static size_t UploadPackTextures(std::vector<uint32_t>& queue, size_t budget)
     {
-        // Clear all textures from the cache
-        for (const auto& [shortcode, texID] : emojiTextureCache) {
-            glDeleteTextures(1, &texID);
+        size_t used = 0;
+        size_t taken = 0;
+        for (; taken < queue.size() && used < budget; ++taken) {
+            uint32_t emojiId = queue[taken];
+            // Skip entries that were promoted, evicted in between or already uploaded
+            TextureLoadState state = textureLoadStates[emojiId];
+            bool pending = state == TextureLoadState::PendingVisible || state == TextureLoadState::PendingPrefetch;
+            if (!pending || textureResidency.isResident(emojiId)) continue;
+
+            int width, height;
+            const unsigned char* mipChain = emojiPack.image(emojiPackTier, emojiId, width, height);
+            InsertIntoAtlas(emojiId, mipChain, width, height);
+            used += GetMipChainBytes(width, height, EmojiAtlas::MIP_LEVELS);
         }
-        emojiTextureCache.clear();
-        textureUsageOrder.clear();
+        queue.erase(queue.begin(), queue.begin() + taken);
+        return used;
     }
 
-    void CleanupTextures()
+    static void UploadDecodedTextures()
+    {
+        TRACE_SCOPE("EmojiManager::UploadDecodedTextures");
+        decodedScratch.clear();
+        if (packVisibleUploads.empty() && packPrefetchUploads.empty()) {
+            EmojiLoader::TakeCompleted(UPLOAD_BUDGET_BYTES, decodedScratch);
+            if (decodedScratch.empty()) return;
+        }
+
+        // Pack images and worker decodes share one budget, pack images first since they are only copied.
+        // Staging holds the padded images and each source may end one image over, so leave headroom.
+        EmojiAtlas::BeginUploadBatch(UPLOAD_BUDGET_BYTES * 2);
+        size_t used = UploadPackTextures(packVisibleUploads, UPLOAD_BUDGET_BYTES);
+        if (used < UPLOAD_BUDGET_BYTES) used += UploadPackTextures(packPrefetchUploads, UPLOAD_BUDGET_BYTES - used);
+        if (decodedScratch.empty() && used < UPLOAD_BUDGET_BYTES) EmojiLoader::TakeCompleted(UPLOAD_BUDGET_BYTES - used, decodedScratch);
+
+        for (DecodedEmoji& decoded : decodedScratch) {
+            if (decoded.pixels.empty()) {
+                GLOG_ERROR("Failed to load texture for emoji: {}", GetEmojiShortcode(decoded.emojiId));
+                textureLoadStates[decoded.emojiId] = TextureLoadState::Failed;
+                continue;
+            }
+            InsertIntoAtlas(decoded.emojiId, decoded.pixels.data(), decoded.width, decoded.height);
+        }
+        EmojiAtlas::EndUploadBatch();
+        // This frame already drew placeholders; draw the new images and upload what the budget left over
+        if (redrawCallback) redrawCallback();
+    }
+
+    void PreloadFrequentlyUsedEmojis()
     {
-        ClearUnusedTextures();
+        // Pinned as well, so the emojis the user reaches for most never miss when the budget is tight
+        for (uint32_t emojiId : pinnedEmojis) {
+            UnpinEmojiTexture(emojiId);
+        }
+        const std::vector<uint32_t>& frequent = EmojiUsage::GetFrequentEmojis();
+        pinnedEmojis = frequent;
+        for (uint32_t emojiId : frequent) {
+            PinEmojiTexture(emojiId);
+            RequestEmojiTexture(emojiId);
+        }
+        UploadDecodedTextures();
+        GLOG_INFO("Preloading {} frequently used emojis.", frequent.size());
+    }
+
+    void PinEmojiTexture(uint32_t emojiId)
+    {
+        textureResidency.pin(emojiId);
+    }
+
+    void UnpinEmojiTexture(uint32_t emojiId)
+    {
+        textureResidency.unpin(emojiId);
     }
 
-    std::string ReplaceEmojiNames(const std::string& text)
+    // Residency keeps its own totals; the registry gets what changed since the last frame
+    static void PublishTextureMetrics()
     {
-        std::string result;
-        size_t start = 0, pos;
+        static GMetricCounter& hits = GMetrics::counter("emoji.texture_hits");
+        static GMetricCounter& misses = GMetrics::counter("emoji.texture_misses");
+        static GMetricCounter& evictions = GMetrics::counter("emoji.texture_evictions");
+        static GMetricGauge& residentBytes = GMetrics::gauge("emoji.texture_resident_bytes");
+        static GMetricGauge& budgetBytes = GMetrics::gauge("emoji.texture_budget_bytes");
+        static TextureResidencyStats published;
 
-        while ((pos = text.find(':', start)) != std::string::npos) {
-            result += text.substr(start, pos - start); // Add text before emoji
-            size_t endPos = text.find(':', pos + 1);
-            if (endPos == std::string::npos) break;
+        TextureResidencyStats stats = textureResidency.stats();
+        hits.add(stats.hits - published.hits);
+        misses.add(stats.misses - published.misses);
+        evictions.add(stats.evictions - published.evictions);
+        residentBytes.set(static_cast<double>(stats.bytesResident));
+        budgetBytes.set(static_cast<double>(stats.bytesBudget));
+        published = stats;
+    }
+
+    void SetRedrawCallback(RedrawCallback callback)
+    {
+        redrawCallback = callback;
+        EmojiLoader::SetCompletedCallback(callback);
+    }
+
+    void EndFrame()
+    {
+        // Upload what the pack or the workers have ready, then trim idle emojis while over budget
+        UploadDecodedTextures();
+        textureResidency.endFrame();
+        PublishTextureMetrics();
+    }
 
-            std::string emojiName = text.substr(pos, endPos - pos + 1);
-            if (emojiNameMap.count(emojiName)) {
-                result += emojiNameMap[emojiName]; // Replace with emoji
+    TextureResidencyStats GetTextureStats()
+    {
+        return textureResidency.stats();
+    }
+
+    void ClearUnusedTextures()
+    {
+        // Release the atlas slots of every emoji that has not been drawn recently
+        textureResidency.evictIdle();
+    }
+
+    void CleanupTextures()
+    {
+        EmojiLoader::Stop();
+        textureResidency.clear();
+        EmojiAtlas::Shutdown();
+    }
+
+    FrameString ReplaceEmojiNames(std::string_view text)
+    {
+        // Same single pass over the text that chat messages use, appending ranges instead of substrings
+        thread_local std::vector<MessageSpan> spans;
+        MessageLayout::Tokenize(text, spans);
+
+        FrameString result;
+        result.reserve(text.size());
+        for (const MessageSpan& span : spans) {
+            if (span.emojiId != INVALID_EMOJI_ID) {
+                result += GetEmoji(span.emojiId).hexcode; // Replace with emoji
             } else {
-                result += emojiName; // Keep the original text if not found
+                result.append(text.data() + span.begin, span.length); // Keep the original text
             }
-            start = endPos + 1;
         }
-
-        result += text.substr(start); // Add remaining text
         return result;
     }
 }
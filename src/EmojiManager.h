@@ -1,27 +1,86 @@
 #pragma once
+#include <cstdint>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
+#include <string_view>
 #include <GLFW/glfw3.h>
+#include "EmojiAtlas.h"
+#include "EmojiIndex.h"
+#include "TextureResidency.h"
+#include "EmojiLoader.h"
+#include "utils/FrameArena.h"
 
+// Views into the loaded emoji index. Strings are NUL-terminated and stay valid
+// until the metadata is reloaded.
 struct EmojiMetadata {
-    std::string emoji;
-    std::string hexcode;
-    std::string group;
-    std::string subgroups;
-    std::string annotation;
-    std::string tags;
+    std::string_view emoji;
+    std::string_view hexcode;
+    std::string_view group;
+    std::string_view subgroups;
+    std::string_view annotation;
+    std::string_view tags;
+    std::string_view shortcode; // ":annotation_with_underscores:"
+    uint16_t groupId;           // Same as the category index
+    uint16_t subgroupId;
+};
+
+// A contiguous range of emoji ids sharing the same group
+struct EmojiCategory {
+    std::string_view name;
+    uint32_t firstEmoji;
+    uint32_t emojiCount;
+};
+
+// Where the metadata memory goes. The baked index is a file mapping, so only the
+// pages that were actually touched count as resident.
+struct EmojiMetadataMemoryReport {
+    bool mapped;                // Baked index mapped from disk, otherwise rebuilt from JSON on the heap
+    size_t indexBytes;          // Whole index image
+    size_t indexResidentBytes;  // Part of the image in physical memory
+    EmojiIndexSectionSizes sections;
+    size_t textureStateBytes;   // Per-emoji load states and residency entries
+    size_t searchIndexBytes;
+    size_t packBytes;           // Pre-decoded image pack, 0 when PNGs are decoded instead
+    size_t packResidentBytes;
+    size_t totalResidentBytes;
 };
 
 namespace EmojiManager {
-    extern std::unordered_map<std::string, std::vector<EmojiMetadata>> emojiCategories;
-    extern std::unordered_map<std::string, std::string> emojiNameMap; // Map for :name: to emoji
+    const uint32_t INVALID_EMOJI_ID = 0xFFFFFFFFu;
 
+    // Maps the baked index next to the JSON (openmoji.idx) and falls back to
+    // parsing the JSON when the index is missing or stale. The pre-decoded image
+    // pack (openmoji.pack) is mapped too when it was baked from the same JSON.
     void LoadEmojiMetadata(const std::string& jsonFilePath);
+    uint32_t GetMetadataGeneration(); // Bumped by every LoadEmojiMetadata; emoji ids from an older generation are stale
+    // Picks the image size for the monitor's content scale; drops resident emojis if it changes
+    void SetDisplayScale(float scale);
+    uint32_t GetEmojiCount();
+    EmojiMetadata GetEmoji(uint32_t emojiId);
+    std::string_view GetEmojiShortcode(uint32_t emojiId); // Reads only the shortcode column
+    const uint32_t* GetEmojiCodepoints(uint32_t emojiId, uint32_t& outCount);
+    uint32_t GetCategoryCount();
+    EmojiCategory GetCategory(uint32_t index);
+    uint32_t FindEmoji(std::string_view shortcode); // INVALID_EMOJI_ID if unknown
+    EmojiMetadataMemoryReport GetMetadataMemoryReport();
+    void LogMetadataMemoryReport();
+
+    // Queues the user's most used emojis (see EmojiUsage) so they are resident before they are
+    // first drawn, and pins them so they stay resident. Needs the GL context: images already in
+    // the pack are uploaded right away.
     void PreloadFrequentlyUsedEmojis();
-    GLuint GetEmojiTexture(const std::string& shortcode);
-    void ClearUnusedTextures();
+    // Never blocks: while an emoji is being decoded in the background the placeholder region
+    // is returned. textureID is 0 if the emoji is unknown or its image failed to load.
+    AtlasRegion GetEmojiTexture(const std::string& shortcode);
+    AtlasRegion GetEmojiTexture(uint32_t emojiId, EmojiLoadPriority priority = EmojiLoadPriority::Visible);
+    void RequestEmojiTexture(uint32_t emojiId); // Prefetch without drawing
+    void PinEmojiTexture(uint32_t emojiId);   // Pinned emojis are never evicted
+    void UnpinEmojiTexture(uint32_t emojiId);
+    void EndFrame();                          // Call once per frame after the UI has been built; uploads decoded emojis
+    // Called, possibly from a worker thread, whenever newly loaded emoji images are ready to be drawn
+    using RedrawCallback = void (*)();
+    void SetRedrawCallback(RedrawCallback callback);
+    TextureResidencyStats GetTextureStats();
+    void ClearUnusedTextures();               // Evicts every emoji that has not been drawn recently
     void CleanupTextures();
-    std::string ReplaceEmojiNames(const std::string& text); // Replace :name: with emoji
+    FrameString ReplaceEmojiNames(std::string_view text); // Replace :name: with emoji, valid until the frame ends
 }
@@ -0,0 +1,84 @@
+#include "EmojiPack.h"
+#include "utils/ImageOps.h"
+
+bool EmojiPack::open(const std::string& path)
+{
+    close();
+    if (!file.open(path)) return false;
+
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+    const auto* candidate = reinterpret_cast<const EmojiPackHeader*>(data);
+    if (size < sizeof(EmojiPackHeader) || candidate->magic != EMOJI_PACK_MAGIC || candidate->version != EMOJI_PACK_VERSION) {
+        file.close();
+        return false;
+    }
+
+    auto sectionFits = [size](uint64_t offset, uint64_t bytes) { return offset % 8 == 0 && offset + bytes <= size; };
+    uint64_t entryCount = uint64_t(candidate->tierCount) * candidate->recordCount;
+    if (candidate->tierCount == 0 ||
+        !sectionFits(candidate->tiersOffset, uint64_t(candidate->tierCount) * sizeof(EmojiPackTier)) ||
+        !sectionFits(candidate->entriesOffset, entryCount * sizeof(EmojiPackEntry)) ||
+        !sectionFits(candidate->pixelsOffset, candidate->pixelsSize)) {
+        file.close();
+        return false;
+    }
+
+    // Check every image once so lookups can trust the table
+    const auto* candidateEntries = reinterpret_cast<const EmojiPackEntry*>(data + candidate->entriesOffset);
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        const EmojiPackEntry& entry = candidateEntries[i];
+        if (entry.offset == EMOJI_PACK_MISSING) continue;
+        if (entry.width == 0 || entry.height == 0 ||
+            entry.offset + GetMipChainBytes(entry.width, entry.height, static_cast<int>(candidate->mipCount)) > candidate->pixelsSize) {
+            file.close();
+            return false;
+        }
+    }
+
+    header = candidate;
+    tiers = reinterpret_cast<const EmojiPackTier*>(data + header->tiersOffset);
+    entries = candidateEntries;
+    pixels = data + header->pixelsOffset;
+    return true;
+}
+
+void EmojiPack::close()
+{
+    file.close();
+    header = nullptr;
+    tiers = nullptr;
+    entries = nullptr;
+    pixels = nullptr;
+}
+
+bool EmojiPack::matchesIndex(uint64_t sourceSize, int64_t sourceTime, uint32_t recordCount, uint32_t mipCount) const
+{
+    return header && header->sourceSize == sourceSize && header->sourceTime == sourceTime &&
+           header->recordCount == recordCount && header->mipCount == mipCount;
+}
+
+uint32_t EmojiPack::selectTier(uint32_t pixelSize) const
+{
+    uint32_t best = 0;
+    for (uint32_t tier = 0; tier < tierCount(); ++tier) {
+        bool bestTooSmall = tiers[best].size < pixelSize;
+        bool fits = tiers[tier].size >= pixelSize;
+        if ((bestTooSmall && tiers[tier].size > tiers[best].size) || (fits && tiers[tier].size < tiers[best].size)) {
+            best = tier;
+        }
+    }
+    return best;
+}
+
+const unsigned char* EmojiPack::image(uint32_t tier, uint32_t emojiId, int& outWidth, int& outHeight) const
+{
+    if (!header || tier >= header->tierCount || emojiId >= header->recordCount) return nullptr;
+
+    const EmojiPackEntry& entry = entries[static_cast<size_t>(tier) * header->recordCount + emojiId];
+    if (entry.offset == EMOJI_PACK_MISSING) return nullptr;
+
+    outWidth = entry.width;
+    outHeight = entry.height;
+    return pixels + entry.offset;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "utils/MappedFile.h"
+
+// Pre-decoded emoji images, baked from the PNGs by emoji_pack_baker.
+//
+// Every emoji is stored once per size tier (e.g. 24 px for 1x displays, 48 px
+// for 2x) as a premultiplied RGBA8 mip chain, ready to be copied into the atlas
+// without decoding or generating mipmaps.
+//
+// Layout (offsets from the start of the file, native byte order):
+//   EmojiPackHeader
+//   EmojiPackTier  tiers[tierCount]
+//   EmojiPackEntry entries[tierCount][recordCount]  indexed by emoji id
+//   unsigned char  pixels[]                         mip chains, level 0 first
+//
+// Emoji ids are the ones of the metadata index the pack was baked against; the
+// source stamp of openmoji.json is stored to detect a mismatch.
+
+const uint32_t EMOJI_PACK_MAGIC = 0x504D534C; // "LMSP"
+const uint32_t EMOJI_PACK_VERSION = 1;
+const uint32_t EMOJI_PACK_MIP_COUNT = 3; // Must match EmojiAtlas::MIP_LEVELS
+const uint64_t EMOJI_PACK_MISSING = 0xFFFFFFFFFFFFFFFFull;
+
+struct EmojiPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceSize;  // Stamp of the openmoji.json the emoji ids come from
+    int64_t sourceTime;
+    uint32_t recordCount;
+    uint32_t tierCount;
+    uint32_t mipCount;    // Levels stored per image
+    uint32_t tiersOffset;
+    uint32_t entriesOffset;
+    uint32_t pixelsOffset;
+    uint64_t pixelsSize;
+};
+
+struct EmojiPackTier {
+    uint32_t size; // Width and height of level 0
+    uint32_t reserved;
+};
+
+struct EmojiPackEntry {
+    uint64_t offset; // Into pixels, EMOJI_PACK_MISSING when the PNG was absent
+    uint16_t width;
+    uint16_t height;
+    uint32_t reserved;
+};
+
+class EmojiPack {
+public:
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // True when the pack was baked against this metadata
+    bool matchesIndex(uint64_t sourceSize, int64_t sourceTime, uint32_t recordCount, uint32_t mipCount) const;
+
+    uint32_t tierCount() const { return header ? header->tierCount : 0; }
+    uint32_t tierSize(uint32_t tier) const { return tiers[tier].size; }
+    // Smallest tier at least pixelSize wide, or the largest tier
+    uint32_t selectTier(uint32_t pixelSize) const;
+
+    // Returns the mip chain of an emoji, or null if the pack has no image for it
+    const unsigned char* image(uint32_t tier, uint32_t emojiId, int& outWidth, int& outHeight) const;
+
+    size_t sizeBytes() const { return file.size(); }
+    size_t residentBytes() const { return file.residentBytes(); }
+
+private:
+    MappedFile file;
+    const EmojiPackHeader* header = nullptr;
+    const EmojiPackTier* tiers = nullptr;
+    const EmojiPackEntry* entries = nullptr;
+    const unsigned char* pixels = nullptr;
+};
@@ -0,0 +1,207 @@
+#include "EmojiSearch.h"
+#include "EmojiManager.h"
+#include "EmojiUsage.h"
+#include "debug/GLogMacros.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace EmojiSearch {
+    const size_t MAX_QUERY_LENGTH = 64;
+    const size_t MAX_CANDIDATES_PER_SOURCE = 512; // Bounds the work for one-letter queries
+
+    // A suffix of a lowercase shortcode that starts at a word boundary
+    struct SuffixEntry {
+        uint32_t offset;  // Into names
+        uint32_t emojiId;
+        uint16_t wordIndex;
+    };
+
+    std::string names;                  // Lowercase shortcodes without colons, NUL-separated
+    std::vector<uint32_t> nameLengths;  // Per emoji id
+    std::vector<SuffixEntry> suffixes;  // Sorted by the suffix text
+
+    std::string tagNames;               // Unique lowercase tags, NUL-separated
+    std::vector<uint32_t> tagOffsets;   // Sorted by tag text
+    std::vector<uint32_t> tagFirstId;   // tagFirstId[i]..tagFirstId[i + 1] indexes tagEmojiIds
+    std::vector<uint32_t> tagEmojiIds;
+
+    static bool StartsWith(const char* text, std::string_view prefix)
+    {
+        return std::strncmp(text, prefix.data(), prefix.size()) == 0;
+    }
+
+    void BuildIndex()
+    {
+        uint32_t emojiCount = EmojiManager::GetEmojiCount();
+
+        names.clear();
+        nameLengths.assign(emojiCount, 0);
+        suffixes.clear();
+        std::map<std::string, std::vector<uint32_t>> tagMap;
+
+        for (uint32_t id = 0; id < emojiCount; ++id) {
+            EmojiMetadata emoji = EmojiManager::GetEmoji(id);
+
+            // Skip emojis whose shortcode is taken by a later duplicate, they cannot be typed
+            if (EmojiManager::FindEmoji(emoji.shortcode) != id) continue;
+
+            // ":grinning_face:" -> "grinning_face"
+            std::string_view shortcode = emoji.shortcode;
+            if (shortcode.size() >= 2) shortcode = shortcode.substr(1, shortcode.size() - 2);
+
+            uint32_t nameOffset = static_cast<uint32_t>(names.size());
+            uint16_t wordIndex = 0;
+            for (size_t i = 0; i < shortcode.size(); ++i) {
+                if (i == 0 || shortcode[i - 1] == '_') {
+                    suffixes.push_back(SuffixEntry{nameOffset + static_cast<uint32_t>(i), id, wordIndex++});
+                }
+                names.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(shortcode[i]))));
+            }
+            names.push_back('\0');
+            nameLengths[id] = static_cast<uint32_t>(shortcode.size());
+
+            // "cheerful, cheery, face" -> one entry per tag
+            std::string_view tags = emoji.tags;
+            while (!tags.empty()) {
+                size_t comma = tags.find(',');
+                std::string_view tag = tags.substr(0, comma);
+                tags = comma == std::string_view::npos ? std::string_view() : tags.substr(comma + 1);
+
+                while (!tag.empty() && tag.front() == ' ') tag.remove_prefix(1);
+                while (!tag.empty() && tag.back() == ' ') tag.remove_suffix(1);
+                if (tag.empty()) continue;
+
+                std::string key(tag);
+                for (char& c : key) c = c == ' ' ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                tagMap[key].push_back(id);
+            }
+        }
+
+        std::sort(suffixes.begin(), suffixes.end(), [](const SuffixEntry& a, const SuffixEntry& b) {
+            return std::strcmp(names.c_str() + a.offset, names.c_str() + b.offset) < 0;
+        });
+
+        // std::map iterates in sorted order, which is what the prefix search needs
+        tagNames.clear();
+        tagOffsets.clear();
+        tagFirstId.clear();
+        tagEmojiIds.clear();
+        for (const auto& [tag, ids] : tagMap) {
+            tagOffsets.push_back(static_cast<uint32_t>(tagNames.size()));
+            tagNames += tag;
+            tagNames.push_back('\0');
+            tagFirstId.push_back(static_cast<uint32_t>(tagEmojiIds.size()));
+            tagEmojiIds.insert(tagEmojiIds.end(), ids.begin(), ids.end());
+        }
+        tagFirstId.push_back(static_cast<uint32_t>(tagEmojiIds.size()));
+
+        GLOG_INFO("Built emoji search index: {} name suffixes, {} tags.", suffixes.size(), tagOffsets.size());
+    }
+
+    // Keeps the best results sorted by descending score, one entry per emoji
+    class TopResults {
+    public:
+        TopResults(EmojiSearchResult* results, size_t capacity) : results(results), capacity(capacity) {}
+
+        void offer(uint32_t emojiId, float score)
+        {
+            if (count == capacity && score <= results[count - 1].score) return;
+
+            size_t pos = count;
+            for (size_t i = 0; i < count; ++i) {
+                if (results[i].emojiId == emojiId) {
+                    if (score <= results[i].score) return;
+                    pos = i;
+                    break;
+                }
+            }
+            if (pos == count) {
+                pos = count < capacity ? count++ : count - 1;
+            }
+
+            // Bubble the new entry up to its place
+            while (pos > 0 && results[pos - 1].score < score) {
+                results[pos] = results[pos - 1];
+                --pos;
+            }
+            results[pos] = EmojiSearchResult{emojiId, score};
+        }
+
+        size_t size() const { return count; }
+
+    private:
+        EmojiSearchResult* results;
+        size_t capacity;
+        size_t count = 0;
+    };
+
+    // Frequently sent emojis float up, with diminishing returns
+    static float UsageBonus(uint32_t emojiId)
+    {
+        float score = EmojiUsage::GetScore(emojiId);
+        return score > 0.0f ? std::log2(1.0f + score) * 1.5f : 0.0f;
+    }
+
+    size_t Query(std::string_view query, EmojiSearchResult* outResults, size_t maxResults)
+    {
+        if (maxResults == 0 || suffixes.empty()) return 0;
+
+        // Normalize into a stack buffer: drop the colons, lowercase, spaces become underscores
+        while (!query.empty() && query.front() == ':') query.remove_prefix(1);
+        while (!query.empty() && query.back() == ':') query.remove_suffix(1);
+        if (query.empty() || query.size() >= MAX_QUERY_LENGTH) return 0;
+
+        char buffer[MAX_QUERY_LENGTH];
+        for (size_t i = 0; i < query.size(); ++i) {
+            char c = query[i];
+            buffer[i] = c == ' ' ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        std::string_view needle(buffer, query.size());
+
+        TopResults top(outResults, maxResults);
+
+        // Shortcode words: a match on the first word beats one later in the name
+        auto suffixIt = std::lower_bound(suffixes.begin(), suffixes.end(), needle, [](const SuffixEntry& entry, std::string_view value) {
+            return std::strncmp(names.c_str() + entry.offset, value.data(), value.size()) < 0;
+        });
+        for (size_t scanned = 0; suffixIt != suffixes.end() && scanned < MAX_CANDIDATES_PER_SOURCE; ++suffixIt, ++scanned) {
+            if (!StartsWith(names.c_str() + suffixIt->offset, needle)) break;
+
+            uint32_t id = suffixIt->emojiId;
+            float score = suffixIt->wordIndex == 0 ? 3.0f : 2.0f;
+            if (suffixIt->wordIndex == 0 && nameLengths[id] == needle.size()) score += 2.0f; // Exact name
+            score -= static_cast<float>(nameLengths[id]) * 0.01f; // Prefer the shorter, more generic name
+            top.offer(id, score + UsageBonus(id));
+        }
+
+        // Tags
+        auto tagIt = std::lower_bound(tagOffsets.begin(), tagOffsets.end(), needle, [](uint32_t offset, std::string_view value) {
+            return std::strncmp(tagNames.c_str() + offset, value.data(), value.size()) < 0;
+        });
+        size_t scanned = 0;
+        for (; tagIt != tagOffsets.end() && scanned < MAX_CANDIDATES_PER_SOURCE; ++tagIt) {
+            const char* tag = tagNames.c_str() + *tagIt;
+            if (!StartsWith(tag, needle)) break;
+
+            float tagScore = tag[needle.size()] == '\0' ? 1.5f : 1.0f;
+            size_t tagIndex = static_cast<size_t>(tagIt - tagOffsets.begin());
+            for (uint32_t i = tagFirstId[tagIndex]; i < tagFirstId[tagIndex + 1] && scanned < MAX_CANDIDATES_PER_SOURCE; ++i, ++scanned) {
+                uint32_t id = tagEmojiIds[i];
+                top.offer(id, tagScore - static_cast<float>(nameLengths[id]) * 0.01f + UsageBonus(id));
+            }
+        }
+
+        return top.size();
+    }
+
+    size_t GetMemoryBytes()
+    {
+        return names.capacity() + nameLengths.capacity() * sizeof(uint32_t) + suffixes.capacity() * sizeof(SuffixEntry) +
+               tagNames.capacity() + (tagOffsets.capacity() + tagFirstId.capacity() + tagEmojiIds.capacity()) * sizeof(uint32_t);
+    }
+}
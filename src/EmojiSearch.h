@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+struct EmojiSearchResult {
+    uint32_t emojiId;
+    float score;
+};
+
+// In-memory search over emoji shortcodes and tags for :shortcode: autocomplete.
+//
+// Shortcodes are indexed as a sorted array of word-start suffixes, so "face"
+// finds ":grinning_face:" as well as ":face_with_tears_of_joy:" with a binary
+// search. Tags go into an inverted index (sorted tag list -> emoji ids).
+// Results are ranked by match quality and the EmojiUsage statistics.
+namespace EmojiSearch {
+    const size_t MAX_RESULTS = 32;
+
+    // Rebuilds the index from the loaded emoji metadata
+    void BuildIndex();
+
+    // Writes up to maxResults best matches, best first. Does not allocate.
+    size_t Query(std::string_view query, EmojiSearchResult* outResults, size_t maxResults);
+
+    size_t GetMemoryBytes(); // Heap taken by the index
+}
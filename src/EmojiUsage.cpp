@@ -0,0 +1,128 @@
+#include "EmojiUsage.h"
+#include "EmojiManager.h"
+#include "debug/GLogMacros.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace EmojiUsage {
+    std::string usageFilePath;
+    std::vector<float> scores;   // Per emoji id, decayed to loadTime
+    int64_t loadTime = 0;        // Unix seconds
+    bool dirty = false;
+
+    std::vector<uint32_t> frequentEmojis;
+    bool frequentEmojisStale = true;
+
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static float Decay(float score, int64_t elapsedSeconds)
+    {
+        if (elapsedSeconds <= 0) return score;
+        double halfLives = static_cast<double>(elapsedSeconds) / (USAGE_HALF_LIFE_DAYS * 24.0 * 60.0 * 60.0);
+        return static_cast<float>(score * std::exp2(-halfLives));
+    }
+
+    void Load(const std::string& filePath)
+    {
+        usageFilePath = filePath;
+        loadTime = Now();
+        scores.assign(EmojiManager::GetEmojiCount(), 0.0f);
+        dirty = false;
+        frequentEmojisStale = true;
+
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            GLOG_INFO("No emoji usage statistics yet: {}", filePath);
+            return;
+        }
+
+        std::unordered_map<std::string_view, uint32_t> idsByHexcode;
+        for (uint32_t id = 0; id < scores.size(); ++id) {
+            idsByHexcode.emplace(EmojiManager::GetEmoji(id).hexcode, id);
+        }
+
+        // One "<hexcode> <score> <unix seconds of the score>" entry per line
+        std::string line;
+        size_t loaded = 0;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            std::string hexcode;
+            float score;
+            int64_t time;
+            if (!(fields >> hexcode >> score >> time)) continue;
+
+            auto it = idsByHexcode.find(hexcode);
+            if (it == idsByHexcode.end()) continue; // Emoji no longer exists
+            scores[it->second] = Decay(score, loadTime - time);
+            loaded++;
+        }
+        GLOG_INFO("Loaded usage statistics for {} emojis from {}.", loaded, filePath);
+    }
+
+    bool Save()
+    {
+        if (!dirty || usageFilePath.empty()) return true;
+
+        // Write to a temporary file first so a crash never leaves half the statistics behind
+        std::string tempPath = usageFilePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::trunc);
+            for (uint32_t id = 0; id < scores.size(); ++id) {
+                if (scores[id] < 0.01f) continue; // Forgotten
+                file << EmojiManager::GetEmoji(id).hexcode << ' ' << scores[id] << ' ' << loadTime << '\n';
+            }
+            if (!file) {
+                GLOG_ERROR("Failed to write emoji usage statistics: {}", tempPath);
+                return false;
+            }
+        }
+        std::remove(usageFilePath.c_str());
+        if (std::rename(tempPath.c_str(), usageFilePath.c_str()) != 0) {
+            GLOG_ERROR("Failed to move emoji usage statistics into place: {}", usageFilePath);
+            return false;
+        }
+
+        dirty = false;
+        return true;
+    }
+
+    void RecordUse(uint32_t emojiId)
+    {
+        if (emojiId >= scores.size()) return;
+
+        // Scores are kept relative to loadTime; a use now is worth more than one back then
+        scores[emojiId] += 1.0f / Decay(1.0f, Now() - loadTime);
+        dirty = true;
+        frequentEmojisStale = true;
+    }
+
+    float GetScore(uint32_t emojiId)
+    {
+        return emojiId < scores.size() ? scores[emojiId] : 0.0f;
+    }
+
+    const std::vector<uint32_t>& GetFrequentEmojis()
+    {
+        if (!frequentEmojisStale) return frequentEmojis;
+
+        frequentEmojis.clear();
+        for (uint32_t id = 0; id < scores.size(); ++id) {
+            if (scores[id] > 0.0f) frequentEmojis.push_back(id);
+        }
+        size_t count = std::min(frequentEmojis.size(), MAX_FREQUENT_EMOJIS);
+        std::partial_sort(frequentEmojis.begin(), frequentEmojis.begin() + count, frequentEmojis.end(),
+                          [](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+        frequentEmojis.resize(count);
+        frequentEmojisStale = false;
+        return frequentEmojis;
+    }
+}
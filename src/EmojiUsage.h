@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-user emoji usage statistics. Every use adds one to an emoji's score and
+// scores halve every USAGE_HALF_LIFE_DAYS, so the ranking follows what the
+// user sends now rather than what they sent a year ago. Entries are keyed by
+// hexcode on disk so they survive changes to the emoji set.
+namespace EmojiUsage {
+    const double USAGE_HALF_LIFE_DAYS = 14.0;
+    const size_t MAX_FREQUENT_EMOJIS = 48;
+
+    // Reads the statistics for the loaded emoji metadata. A missing file is not an error.
+    void Load(const std::string& filePath);
+    // Writes the statistics back if they changed since the last load or save
+    bool Save();
+
+    void RecordUse(uint32_t emojiId);
+    float GetScore(uint32_t emojiId); // Decayed use count, 0 for unused emojis
+
+    // Emoji ids with the highest scores, best first, at most MAX_FREQUENT_EMOJIS
+    const std::vector<uint32_t>& GetFrequentEmojis();
+}
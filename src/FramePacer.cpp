@@ -0,0 +1,95 @@
+#include "FramePacer.h"
+#include "debug/GMetrics.h"
+#include "debug/GTrace.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+double FramePacer::effectiveFps() const
+{
+    double fps = targetFps > 0.0 ? targetFps : refreshRate;
+    if (!isFocused && unfocusedFps > 0.0) fps = std::min(fps, unfocusedFps);
+    return fps;
+}
+
+int FramePacer::swapInterval() const
+{
+    if (!vsync) return 0;
+    // The smallest whole number of vblanks that stays at or under the target, with some slack for 59.94 Hz displays
+    int interval = static_cast<int>(std::ceil(refreshRate / effectiveFps() - 0.05));
+    return std::max(interval, 1);
+}
+
+void FramePacer::sleepUntil(Clock::time_point target)
+{
+    // Sleep in 1 ms slices while the remaining time is clearly longer than a slice can overshoot
+    while (true) {
+        auto now = Clock::now();
+        double remainingNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(target - now).count());
+        if (remainingNs <= sleepEstimateNs) break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        double sleptNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - now).count());
+
+        // Estimate = mean + one standard deviation of what a slice really took
+        ++sleepSamples;
+        double delta = sleptNs - sleepMeanNs;
+        sleepMeanNs += delta / static_cast<double>(sleepSamples);
+        sleepM2 += delta * (sleptNs - sleepMeanNs);
+        sleepEstimateNs = sleepMeanNs + std::sqrt(sleepM2 / static_cast<double>(sleepSamples - 1));
+    }
+
+    while (Clock::now() < target) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordLateness(Clock::duration lateness, bool missed)
+{
+    static GMetricCounter& missedDeadlines = GMetrics::counter("frame.pacer_missed");
+    static GMetricHistogram& latenessHistogram = GMetrics::histogram("frame.pacer_lateness_ns");
+
+    double latenessMs = std::max(std::chrono::duration<double, std::milli>(lateness).count(), 0.0);
+    stats_.frames++;
+    if (missed) {
+        stats_.missedDeadlines++;
+        missedDeadlines.add();
+    }
+    latenessSumMs += latenessMs;
+    stats_.averageLatenessMs = latenessSumMs / static_cast<double>(stats_.frames);
+    stats_.maxLatenessMs = std::max(stats_.maxLatenessMs, latenessMs);
+    latenessHistogram.record(static_cast<uint64_t>(latenessMs * 1e6));
+}
+
+void FramePacer::waitForNextFrame()
+{
+    TRACE_SCOPE("FramePacer::waitForNextFrame");
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(swapInterval() > 0 ? swapInterval() / refreshRate : 1.0 / effectiveFps()));
+    auto now = Clock::now();
+    if (!hasDeadline) {
+        deadline = now + interval;
+        hasDeadline = true;
+        return;
+    }
+
+    if (vsync) {
+        // The swap already blocked until the vblank; a present more than half a refresh
+        // after the expected one means at least one vblank was missed
+        auto lateness = now - deadline;
+        auto halfRefresh = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(0.5 / refreshRate));
+        recordLateness(lateness, lateness > halfRefresh);
+        deadline = now + interval;
+        return;
+    }
+
+    if (now >= deadline) {
+        // The frame overran its budget; start over from now instead of rushing to catch up
+        recordLateness(now - deadline, true);
+        deadline = now + interval;
+        return;
+    }
+
+    sleepUntil(deadline);
+    recordLateness(Clock::now() - deadline, false);
+    deadline += interval;
+}
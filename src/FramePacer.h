@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+struct FramePacerStats {
+    uint64_t frames = 0;          // Paced frames, resumed frames after an idle wait are not counted
+    uint64_t missedDeadlines = 0; // Frames that arrived after their deadline
+    double averageLatenessMs = 0.0;
+    double maxLatenessMs = 0.0;
+};
+
+// Paces frames to a target rate. Call waitForNextFrame() right after the buffer swap.
+//
+// With vsync on the swap itself does the waiting: the pacer turns the target rate into a
+// swap interval (the refresh rate divided by a whole number, never above the target) and
+// only measures. With vsync off it waits for the deadline itself, sleeping in short slices
+// while the remaining time is well above the measured sleep overshoot and spinning for the
+// rest, so the wake-up is precise without burning a core for the whole frame.
+class FramePacer {
+public:
+    static constexpr double MATCH_REFRESH = 0.0;          // Target rate that follows the monitor
+    static constexpr double DEFAULT_UNFOCUSED_FPS = 20.0; // Low-power cap while the window is in the background
+
+    void setRefreshRate(double hz) { refreshRate = hz > 0.0 ? hz : 60.0; }
+    void setTargetFps(double fps) { targetFps = fps; }
+    void setUnfocusedFps(double fps) { unfocusedFps = fps; }
+    void setFocused(bool focused) { isFocused = focused; }
+    void setVsync(bool enabled) { vsync = enabled; }
+
+    double effectiveFps() const;
+    // glfwSwapInterval() value for the current settings, 0 when vsync is off
+    int swapInterval() const;
+
+    void waitForNextFrame();
+    // Forget the deadline, e.g. after the loop slept waiting for events, so the gap is not counted as a miss
+    void reset() { hasDeadline = false; }
+
+    const FramePacerStats& stats() const { return stats_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void sleepUntil(Clock::time_point deadline);
+    void recordLateness(Clock::duration lateness, bool missed);
+
+    double refreshRate = 60.0;
+    double targetFps = MATCH_REFRESH;
+    double unfocusedFps = DEFAULT_UNFOCUSED_FPS;
+    bool isFocused = true;
+    bool vsync = true;
+
+    Clock::time_point deadline;
+    bool hasDeadline = false;
+
+    // Running mean and variance of how long a 1 ms sleep really takes (Welford)
+    double sleepEstimateNs = 2e6;
+    double sleepMeanNs = 1e6;
+    double sleepM2 = 0.0;
+    uint64_t sleepSamples = 1;
+
+    double latenessSumMs = 0.0;
+    FramePacerStats stats_;
+};
@@ -1,12 +1,288 @@
 #include "Interface.h"
 #include "EmojiManager.h"
+#include "EmojiSearch.h"
+#include "EmojiUsage.h"
+#include "ChatView.h"
+#include "RichTextLayout.h"
+#include "utils/FrameArena.h"
+#include "RenderScheduler.h"
 #include "imgui.h"
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
 #include "debug/GLogMacros.h"
+#include "debug/GTrace.h"
 
 namespace Interface {
+    // Emoji quads are drawn on a second draw list channel. When the channels are
+    // merged, consecutive emoji from the same atlas page collapse into a single
+    // draw command instead of alternating with the font texture.
+    static bool emojiBatchActive = false;
+    static char chatInput[256] = "";
+
+    static ImTextureID ToTextureID(GLuint textureID)
+    {
+        return (ImTextureID)(intptr_t)textureID;
+    }
+
+    // Atlas pixels are premultiplied, so the emoji channel blends with ONE instead of SRC_ALPHA
+    static void SetPremultipliedBlend(const ImDrawList*, const ImDrawCmd*)
+    {
+        glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    static void BeginEmojiBatch()
+    {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->ChannelsSplit(2);
+        drawList->ChannelsSetCurrent(1);
+        drawList->AddCallback(SetPremultipliedBlend, nullptr);
+        drawList->ChannelsSetCurrent(0);
+        emojiBatchActive = true;
+    }
+
+    static void EndEmojiBatch()
+    {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->ChannelsSetCurrent(1);
+        drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr); // Back to the backend's blend state
+        drawList->ChannelsSetCurrent(0);
+        drawList->ChannelsMerge();
+        emojiBatchActive = false;
+    }
+
+    // Must be called between BeginEmojiBatch() and EndEmojiBatch()
+    static void DrawEmoji(const AtlasRegion& region, const ImVec2& size)
+    {
+        ImVec2 pos = ImGui::GetCursorScreenPos();
+        ImGui::Dummy(size); // Reserve layout space like ImGui::Image would
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        IM_ASSERT(emojiBatchActive);
+        drawList->ChannelsSetCurrent(1);
+        drawList->AddImage(ToTextureID(region.textureID), pos, ImVec2(pos.x + size.x, pos.y + size.y),
+                           ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+        drawList->ChannelsSetCurrent(0);
+    }
+
+    const float MESSAGE_EMOJI_SIZE = 20.0f;
+    const float CHAT_OVERSCAN = 200.0f; // Pixels above and below the view that are measured ahead of time
+    const size_t MAX_CACHED_LAYOUTS = 1024; // Per conversation; the cache starts over when it grows past this
+
+    // A conversation, the scroll state of its log and the layouts of the messages around the view
+    struct Conversation {
+        ChatHistory history;
+        ChatView view;
+        std::unordered_map<uint64_t, RichTextLayout> layouts; // Keyed by message id
+        uint32_t emojiGeneration = 0; // EmojiManager metadata the spans were resolved against
+    };
+
+    // Resolves the spans again when the emoji metadata was reloaded, since emoji ids may have moved
+    static void SyncEmojiMetadata(Conversation& conversation)
+    {
+        uint32_t generation = EmojiManager::GetMetadataGeneration();
+        if (conversation.emojiGeneration == generation) return;
+        if (conversation.emojiGeneration != 0) {
+            conversation.history.retokenize(); // Bumps the revision, which drops the cached layouts
+            conversation.view.invalidate();
+        }
+        conversation.emojiGeneration = generation;
+    }
+
+    // Lays the message out again only when its content, the font or the wrap width changed
+    static const RichTextLayout& GetMessageLayout(Conversation& conversation, const ChatMessage& message, float wrapWidth)
+    {
+        RichTextStyle style{ImGui::GetFont(), ImGui::GetFontSize(), MESSAGE_EMOJI_SIZE};
+        RichTextLayout& layout = conversation.layouts[message.id];
+        if (!layout.isCurrent(style, wrapWidth, conversation.history.revision())) {
+            FrameString prefix(message.author.begin(), message.author.end());
+            prefix += ": ";
+            RichText::Layout(prefix, message.text, message.spans, style, wrapWidth, layout);
+            layout.revision = conversation.history.revision();
+        }
+        return layout;
+    }
+
+    // Draws the messages in view plus CHAT_OVERSCAN, so the cost does not depend on the history length
+    static void RenderChatLog(Conversation& conversation)
+    {
+        TRACE_SCOPE("Interface::RenderChatLog");
+        const ChatHistory& history = conversation.history;
+        ChatView& view = conversation.view;
+        if (conversation.layouts.size() > MAX_CACHED_LAYOUTS) conversation.layouts.clear();
+
+        float viewHeight = ImGui::GetWindowHeight();
+        float originY = ImGui::GetCursorPosY();
+
+        // Follow new messages unless the user scrolled away from the bottom (judged on last frame's content)
+        view.stickToBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY() - 1.0f;
+        view.setWrapWidth(ImGui::GetContentRegionAvail().x);
+        view.sync(history.size(), ImGui::GetTextLineHeightWithSpacing());
+
+        // Measure what is in or near the view. Rows above the first visible one push it down as
+        // they change height, so the scroll position follows them to keep the view still.
+        double scrollY = view.stickToBottom ? std::max(0.0, view.totalHeight() - viewHeight) : ImGui::GetScrollY();
+        size_t firstVisible = view.indexAt(scrollY);
+        double anchorShift = 0.0;
+        for (size_t i = view.indexAt(scrollY - CHAT_OVERSCAN); i < view.size() && view.offsetOf(i) < scrollY + viewHeight + CHAT_OVERSCAN; ++i) {
+            if (view.isMeasured(i)) continue;
+            float previous = view.height(i);
+            view.setHeight(i, GetMessageLayout(conversation, history[i], view.wrapWidth()).height + ImGui::GetStyle().ItemSpacing.y);
+            if (i < firstVisible) anchorShift += view.height(i) - previous;
+        }
+
+        double targetScroll = view.stickToBottom ? std::max(0.0, view.totalHeight() - viewHeight) : scrollY + anchorShift;
+        if (targetScroll != ImGui::GetScrollY()) {
+            ImGui::SetScrollY(static_cast<float>(targetScroll));
+            RenderScheduler::RequestRedraw(); // The scroll only applies next frame
+        }
+
+        // This frame still shows the current scroll position; cover the target too unless it is a jump
+        double drawTop = targetScroll;
+        double drawBottom = targetScroll + viewHeight;
+        double currentScroll = ImGui::GetScrollY();
+        if (std::abs(currentScroll - targetScroll) < viewHeight) {
+            drawTop = std::min(drawTop, currentScroll);
+            drawBottom = std::max(drawBottom, currentScroll + viewHeight);
+        }
+
+        BeginEmojiBatch();
+        for (size_t i = view.indexAt(drawTop); i < view.size() && view.offsetOf(i) < drawBottom; ++i) {
+            ImGui::SetCursorPosY(originY + static_cast<float>(view.offsetOf(i)));
+            RenderMessage(history[i], GetMessageLayout(conversation, history[i], view.wrapWidth()));
+        }
+        EndEmojiBatch();
+
+        // Extend the content to the full history so the scrollbar covers it
+        ImGui::SetCursorPosY(originY + static_cast<float>(view.totalHeight()));
+        ImGui::Dummy(ImVec2(0.0f, 0.0f));
+    }
+
+    // :shortcode: autocomplete for the chat input
+    struct EmojiAutocomplete {
+        EmojiSearchResult results[8];
+        size_t resultCount = 0;
+        char query[64] = "";
+        int tokenStart = -1; // Offset of the ':' opening the token under the cursor, -1 when inactive
+        int selected = 0;
+        bool popupHovered = false;
+        uint32_t pendingEmoji = EmojiManager::INVALID_EMOJI_ID; // Picked with the mouse, applied next frame
+    };
+    static EmojiAutocomplete autocomplete;
+
+    // Finds a ":token" that ends at the cursor. The ':' must start a word so times like 12:30 are ignored.
+    static int FindShortcodeToken(const char* buf, int cursor)
+    {
+        for (int i = cursor - 1; i >= 0; --i) {
+            char c = buf[i];
+            if (c == ':') return (i == 0 || buf[i - 1] == ' ') ? i : -1;
+            if (c == ' ') return -1;
+        }
+        return -1;
+    }
+
+    static void UpdateAutocomplete(const char* buf, int cursor)
+    {
+        autocomplete.tokenStart = FindShortcodeToken(buf, cursor);
+        int tokenLength = cursor - autocomplete.tokenStart - 1;
+        if (autocomplete.tokenStart < 0 || tokenLength < 2 || tokenLength >= IM_ARRAYSIZE(autocomplete.query)) {
+            autocomplete.tokenStart = -1;
+            autocomplete.resultCount = 0;
+            autocomplete.query[0] = '\0';
+            return;
+        }
+
+        // Only search again when the token changed, so the selection survives between frames
+        std::string_view token(buf + autocomplete.tokenStart + 1, tokenLength);
+        if (token == autocomplete.query) return;
+
+        std::copy(token.begin(), token.end(), autocomplete.query);
+        autocomplete.query[tokenLength] = '\0';
+        autocomplete.resultCount = EmojiSearch::Query(token, autocomplete.results, IM_ARRAYSIZE(autocomplete.results));
+        autocomplete.selected = 0;
+    }
+
+    static void AcceptCompletion(ImGuiInputTextCallbackData* data, uint32_t emojiId)
+    {
+        std::string_view shortcode = EmojiManager::GetEmojiShortcode(emojiId);
+        data->DeleteChars(autocomplete.tokenStart, data->CursorPos - autocomplete.tokenStart);
+        data->InsertChars(autocomplete.tokenStart, shortcode.data(), shortcode.data() + shortcode.size());
+        data->InsertChars(data->CursorPos, " ");
+        data->SelectionStart = data->SelectionEnd = data->CursorPos;
+
+        autocomplete.tokenStart = -1;
+        autocomplete.resultCount = 0;
+        autocomplete.query[0] = '\0';
+    }
+
+    static int ChatInputCallback(ImGuiInputTextCallbackData* data)
+    {
+        switch (data->EventFlag) {
+        case ImGuiInputTextFlags_CallbackCompletion: // Tab accepts the selected suggestion
+            if (autocomplete.resultCount > 0) {
+                AcceptCompletion(data, autocomplete.results[autocomplete.selected].emojiId);
+            }
+            break;
+        case ImGuiInputTextFlags_CallbackHistory: // Up/Down move the selection
+            if (autocomplete.resultCount > 0) {
+                int count = static_cast<int>(autocomplete.resultCount);
+                int step = data->EventKey == ImGuiKey_UpArrow ? count - 1 : 1;
+                autocomplete.selected = (autocomplete.selected + step) % count;
+            }
+            break;
+        case ImGuiInputTextFlags_CallbackAlways:
+            if (autocomplete.pendingEmoji != EmojiManager::INVALID_EMOJI_ID) {
+                autocomplete.tokenStart = FindShortcodeToken(data->Buf, data->CursorPos);
+                if (autocomplete.tokenStart >= 0) AcceptCompletion(data, autocomplete.pendingEmoji);
+                autocomplete.pendingEmoji = EmojiManager::INVALID_EMOJI_ID;
+            }
+            UpdateAutocomplete(data->Buf, data->CursorPos);
+            break;
+        }
+        return 0;
+    }
+
+    // Suggestion list drawn just above the chat input
+    static void RenderAutocompletePopup(const ImVec2& anchor)
+    {
+        autocomplete.popupHovered = false;
+        if (autocomplete.tokenStart < 0 || autocomplete.resultCount == 0) return;
+
+        ImGui::SetNextWindowPos(anchor, ImGuiCond_Always, ImVec2(0.0f, 1.0f));
+        ImGui::Begin("##EmojiAutocomplete", nullptr,
+                     ImGuiWindowFlags_NoTitleBar |
+                         ImGuiWindowFlags_NoResize |
+                         ImGuiWindowFlags_NoMove |
+                         ImGuiWindowFlags_NoSavedSettings |
+                         ImGuiWindowFlags_AlwaysAutoResize |
+                         ImGuiWindowFlags_NoFocusOnAppearing |
+                         ImGuiWindowFlags_NoNav);
+        BeginEmojiBatch();
+        for (size_t i = 0; i < autocomplete.resultCount; ++i) {
+            uint32_t emojiId = autocomplete.results[i].emojiId;
+            EmojiMetadata emoji = EmojiManager::GetEmoji(emojiId);
+
+            ImGui::PushID(static_cast<int>(i));
+            AtlasRegion region = EmojiManager::GetEmojiTexture(emojiId);
+            if (region.textureID != 0) DrawEmoji(region, ImVec2(20, 20));
+            else ImGui::Dummy(ImVec2(20, 20));
+            ImGui::SameLine();
+            if (ImGui::Selectable(emoji.shortcode.data(), static_cast<int>(i) == autocomplete.selected)) {
+                autocomplete.pendingEmoji = emojiId;
+            }
+            ImGui::PopID();
+        }
+        EndEmojiBatch();
+        autocomplete.popupHovered = ImGui::IsWindowHovered();
+        ImGui::End();
+    }
+
     void RenderMainWindow()
     {
+        TRACE_SCOPE("Interface::RenderMainWindow");
         // 🔄 State Management
         enum class PanelMode
         {
@@ -15,6 +291,7 @@ namespace Interface {
         };
         static PanelMode panelMode = PanelMode::ChannelView;
         static std::string selectedFriend = "";
+        static std::unordered_map<std::string, Conversation> conversations; // Keyed by friend name
 
         // === Main Window Setup ===
         ImGui::Begin("MainWindow", nullptr,
@@ -93,12 +370,31 @@ namespace Interface {
 
         ImGui::BeginChild("ChatLog", ImVec2(0, winH - 60), true);
 
+        ChatHistory* conversation = nullptr;
         if (panelMode == PanelMode::FriendsView && !selectedFriend.empty())
         {
-            ImGui::TextWrapped("%s: Hello!", selectedFriend.c_str());
-            RenderMessage("Hello there! :grinning_face: How are you?"); // Example with text and emoji
-            RenderMessage("I love this! :grinning_face_with_big_eyes:"); // Example with another emoji
-            // RenderMessage("Flags are cool! :happy:"); // Example with a flag emoji
+            Conversation& selected = conversations[selectedFriend];
+            SyncEmojiMetadata(selected);
+            conversation = &selected.history;
+            if (conversation->empty())
+            {
+                // Example conversation until messages arrive over the network
+                conversation->addMessage(selectedFriend, "Hello!");
+                conversation->addMessage(selectedFriend, "Hello there! :grinning_face: How are you?"); // Example with text and emoji
+                conversation->addMessage(selectedFriend, "I love this! :grinning_face_with_big_eyes:"); // Example with another emoji
+
+                // LMS_CHAT_STRESS=<count> pads the example with generated messages to profile long histories
+                if (const char* stress = std::getenv("LMS_CHAT_STRESS"))
+                {
+                    long count = std::atol(stress);
+                    for (long i = 0; i < count; ++i)
+                    {
+                        conversation->addMessage(selectedFriend, i % 3 ? "Message " + std::to_string(i) : "Message " + std::to_string(i) + " :thumbs_up:");
+                    }
+                }
+            }
+
+            RenderChatLog(selected);
         }
         else
         {
@@ -108,78 +404,199 @@ namespace Interface {
         ImGui::EndChild(); // ChatLog
 
         // === Chat Input ===
-        static char inputBuf[256] = "";
         ImGui::SetCursorPosY(winH - 25);
         ImGui::PushItemWidth(-1);
-        if (ImGui::InputText("##ChatInput", inputBuf, IM_ARRAYSIZE(inputBuf),
-                             ImGuiInputTextFlags_EnterReturnsTrue))
+        if (autocomplete.pendingEmoji != EmojiManager::INVALID_EMOJI_ID)
         {
-            // TODO: send message
-            inputBuf[0] = '\0';
+            ImGui::SetKeyboardFocusHere(); // A suggestion was clicked, give the input focus back to apply it
         }
+        if (ImGui::InputText("##ChatInput", chatInput, IM_ARRAYSIZE(chatInput),
+                             ImGuiInputTextFlags_EnterReturnsTrue |
+                                 ImGuiInputTextFlags_CallbackAlways |
+                                 ImGuiInputTextFlags_CallbackCompletion |
+                                 ImGuiInputTextFlags_CallbackHistory,
+                             ChatInputCallback))
+        {
+            // TODO: send over the network; for now the message only goes into the local history
+            if (conversation && chatInput[0] != '\0')
+            {
+                uint64_t messageId = conversation->addMessage("You", chatInput);
+                for (const MessageSpan& span : conversation->findMessage(messageId)->spans)
+                {
+                    if (span.emojiId != EmojiManager::INVALID_EMOJI_ID) EmojiUsage::RecordUse(span.emojiId); // Sent emojis feed the rankings
+                }
+            }
+            chatInput[0] = '\0';
+            autocomplete.tokenStart = -1;
+            autocomplete.resultCount = 0;
+        }
+        if (!ImGui::IsItemActive() && !autocomplete.popupHovered &&
+            autocomplete.pendingEmoji == EmojiManager::INVALID_EMOJI_ID)
+        {
+            autocomplete.tokenStart = -1; // Hide suggestions once the input loses focus
+        }
+        ImVec2 inputMin = ImGui::GetItemRectMin();
         ImGui::PopItemWidth();
+        RenderAutocompletePopup(ImVec2(inputMin.x, inputMin.y - 4));
 
         ImGui::EndChild(); // RightPanel
 
         ImGui::End(); // MainWindow
     }
 
-    void RenderEmojiBrowser()
+    // Appends ":shortcode: " to the chat input, e.g. when an emoji is picked in the browser
+    static void InsertIntoChatInput(uint32_t emojiId)
     {
-        ImGui::Begin("Emoji Browser");
-        for (const auto& [category, emojis] : EmojiManager::emojiCategories) {
-            ImGui::Text("%s", category.c_str());
-            ImGui::Separator();
+        std::string_view shortcode = EmojiManager::GetEmojiShortcode(emojiId);
+        size_t length = std::strlen(chatInput);
+        if (length + shortcode.size() + 1 >= sizeof(chatInput)) return;
 
-            for (const auto& emoji : emojis) {
-                ImGui::Text("%s (%s)", emoji.emoji.c_str(), emoji.annotation.c_str());
-                ImGui::SameLine();
-            }
-            ImGui::NewLine();
-        }
-        ImGui::End();
+        std::copy(shortcode.begin(), shortcode.end(), chatInput + length);
+        length += shortcode.size();
+        chatInput[length++] = ' ';
+        chatInput[length] = '\0';
     }
 
-    void RenderMessage(const std::string& message)
+    // Fixed-size cells let ImGuiListClipper skip every row that is not on screen, so
+    // the per-frame cost only depends on the window size, not on the category size
+    // idAt(i) maps a cell index in [0, emojiCount) to an emoji id
+    template <typename IdAt>
+    static void RenderEmojiGrid(uint32_t emojiCount, IdAt idAt)
     {
-        std::string processedMessage = message;
-        size_t pos = 0;
+        const float cellSize = 28.0f;
+        const float emojiSize = 24.0f;
+        const int prefetchRows = 3; // Rows above and below the view whose textures are requested early
+
+        ImGui::BeginChild("EmojiGrid");
+
+        int columns = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().x / cellSize));
+        int rows = static_cast<int>((emojiCount + columns - 1) / columns);
+        float rowHeight = cellSize + ImGui::GetStyle().ItemSpacing.y;
 
-        ImGui::BeginGroup(); // Group text and images together
+        int firstVisibleRow = rows;
+        int lastVisibleRow = -1;
 
-        while ((pos = processedMessage.find(':')) != std::string::npos) {
-            size_t endPos = processedMessage.find(':', pos + 1);
-            if (endPos == std::string::npos) break;
+        BeginEmojiBatch();
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, rowHeight);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                firstVisibleRow = std::min(firstVisibleRow, row);
+                lastVisibleRow = std::max(lastVisibleRow, row);
 
-            std::string emojiName = processedMessage.substr(pos, endPos - pos + 1);
-            std::string textBeforeEmoji = processedMessage.substr(0, pos);
+                for (int column = 0; column < columns; ++column) {
+                    uint32_t index = static_cast<uint32_t>(row * columns + column);
+                    if (index >= emojiCount) break;
+                    uint32_t emojiId = idAt(index);
 
-            // Render text before the emoji
-            if (!textBeforeEmoji.empty()) {
-                ImGui::TextUnformatted(textBeforeEmoji.c_str());
-                ImGui::SameLine(0, 0); // Avoid spacing between text and emoji
+                    if (column > 0) ImGui::SameLine(0, 0);
+                    ImVec2 cellPos = ImGui::GetCursorScreenPos();
+
+                    ImGui::PushID(static_cast<int>(emojiId));
+                    if (ImGui::InvisibleButton("##emoji", ImVec2(cellSize, cellSize))) {
+                        InsertIntoChatInput(emojiId);
+                    }
+                    bool hovered = ImGui::IsItemHovered();
+                    ImGui::PopID();
+
+                    ImDrawList* drawList = ImGui::GetWindowDrawList();
+                    if (hovered) {
+                        drawList->AddRectFilled(cellPos, ImVec2(cellPos.x + cellSize, cellPos.y + cellSize),
+                                                ImGui::GetColorU32(ImGuiCol_Header), 4.0f);
+                        ImGui::SetTooltip("%s", EmojiManager::GetEmojiShortcode(emojiId).data());
+                    }
+
+                    AtlasRegion region = EmojiManager::GetEmojiTexture(emojiId);
+                    if (region.textureID != 0) {
+                        float inset = (cellSize - emojiSize) * 0.5f;
+                        ImVec2 emojiPos(cellPos.x + inset, cellPos.y + inset);
+                        drawList->ChannelsSetCurrent(1);
+                        drawList->AddImage(ToTextureID(region.textureID), emojiPos, ImVec2(emojiPos.x + emojiSize, emojiPos.y + emojiSize),
+                                           ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+                        drawList->ChannelsSetCurrent(0);
+                    }
+                }
             }
+        }
+        clipper.End();
+        EndEmojiBatch();
 
-            // Render the emoji as an image if it exists
-            GLuint emojiTexture = EmojiManager::GetEmojiTexture(emojiName);
-            if (emojiTexture != 0) {
-                ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<void*>(reinterpret_cast<intptr_t*>(emojiTexture))), ImVec2(20, 20)); // Correctly cast GLuint to ImTextureID
-                ImGui::SameLine(0, 0); // Avoid spacing between emoji and next text
-            } else {
-                // If emoji not found, render the placeholder text
-                ImGui::TextUnformatted(emojiName.c_str());
-                ImGui::SameLine(0, 0);
+        // Queue the rows just outside the view so scrolling rarely shows placeholders
+        if (lastVisibleRow >= 0) {
+            int prefetchBegin = std::max(0, firstVisibleRow - prefetchRows);
+            int prefetchEnd = std::min(rows, lastVisibleRow + 1 + prefetchRows);
+            for (int row = prefetchBegin; row < prefetchEnd; ++row) {
+                if (row >= firstVisibleRow && row <= lastVisibleRow) continue;
+                for (int column = 0; column < columns; ++column) {
+                    uint32_t index = static_cast<uint32_t>(row * columns + column);
+                    if (index >= emojiCount) break;
+                    EmojiManager::RequestEmojiTexture(idAt(index));
+                }
             }
+        }
 
-            // Update the remaining message
-            processedMessage = processedMessage.substr(endPos + 1);
+        ImGui::EndChild();
+    }
+
+    void RenderEmojiBrowser()
+    {
+        TRACE_SCOPE("Interface::RenderEmojiBrowser");
+        ImGui::Begin("Emoji Browser");
+        if (ImGui::BeginTabBar("EmojiCategories", ImGuiTabBarFlags_FittingPolicyScroll)) {
+            const std::vector<uint32_t>& frequent = EmojiUsage::GetFrequentEmojis();
+            if (!frequent.empty() && ImGui::BeginTabItem("frequently-used")) {
+                RenderEmojiGrid(static_cast<uint32_t>(frequent.size()), [&](uint32_t index) { return frequent[index]; });
+                ImGui::EndTabItem();
+            }
+            for (uint32_t categoryIndex = 0; categoryIndex < EmojiManager::GetCategoryCount(); ++categoryIndex) {
+                EmojiCategory category = EmojiManager::GetCategory(categoryIndex);
+                if (ImGui::BeginTabItem(category.name.data())) {
+                    RenderEmojiGrid(category.emojiCount, [&](uint32_t index) { return category.firstEmoji + index; });
+                    ImGui::EndTabItem();
+                }
+            }
+            ImGui::EndTabBar();
         }
+        ImGui::End();
+    }
+
+    void RenderMessage(const ChatMessage& message, const RichTextLayout& layout)
+    {
+        // Straight into the draw list: the layout already holds every position, so no
+        // widgets are submitted and lines outside the clip rect cost one comparison
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        float clipTop = drawList->GetClipRectMin().y;
+        float clipBottom = drawList->GetClipRectMax().y;
+        ImU32 color = ImGui::GetColorU32(ImGuiCol_Text);
+        const char* text = message.text.c_str();
+        const char* prefix = layout.prefix.c_str();
 
-        // Render any remaining text
-        if (!processedMessage.empty()) {
-            ImGui::TextUnformatted(processedMessage.c_str());
+        IM_ASSERT(emojiBatchActive);
+        for (const RichTextLine& line : layout.lines) {
+            float top = origin.y + line.y;
+            if (top + line.height < clipTop || top > clipBottom) continue;
+
+            for (uint32_t i = line.firstItem; i < line.firstItem + line.itemCount; ++i) {
+                const RichTextItem& item = layout.items[i];
+                if (item.emojiId == EmojiManager::INVALID_EMOJI_ID) {
+                    const char* source = item.inPrefix ? prefix : text;
+                    ImVec2 pos(origin.x + item.x, top + (line.height - layout.style.fontSize) * 0.5f);
+                    drawList->AddText(layout.style.font, layout.style.fontSize, pos, color, source + item.begin, source + item.begin + item.length);
+                    continue;
+                }
+
+                // The space stays reserved while the image loads, so the layout does not change when it arrives
+                AtlasRegion region = EmojiManager::GetEmojiTexture(item.emojiId);
+                if (region.textureID == 0) continue;
+                ImVec2 pos(origin.x + item.x, top + (line.height - item.width) * 0.5f);
+                drawList->ChannelsSetCurrent(1);
+                drawList->AddImage(ToTextureID(region.textureID), pos, ImVec2(pos.x + item.width, pos.y + item.width),
+                                   ImVec2(region.u0, region.v0), ImVec2(region.u1, region.v1));
+                drawList->ChannelsSetCurrent(0);
+            }
         }
 
-        ImGui::EndGroup();
+        ImGui::Dummy(ImVec2(layout.width, layout.height)); // Reserve the space like a widget would
     }
 }
@@ -1,8 +1,10 @@
 #pragma once
 #include <string> // Include the string header
+#include "ChatHistory.h"
+#include "RichTextLayout.h"
 
 namespace Interface {
     void RenderMainWindow();
     void RenderEmojiBrowser();
-    void RenderMessage(const std::string& message); // Correct declaration
+    void RenderMessage(const ChatMessage& message, const RichTextLayout& layout); // Draws a laid-out message at the cursor
 }
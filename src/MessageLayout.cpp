@@ -0,0 +1,43 @@
+#include "MessageLayout.h"
+#include "EmojiManager.h"
+
+namespace MessageLayout {
+    static void AppendText(std::vector<MessageSpan>& spans, size_t begin, size_t end)
+    {
+        if (begin == end) return;
+
+        // Merge with the previous text span so a rejected ":" does not split the run
+        if (!spans.empty() && spans.back().emojiId == EmojiManager::INVALID_EMOJI_ID &&
+            spans.back().begin + spans.back().length == begin) {
+            spans.back().length += static_cast<uint32_t>(end - begin);
+            return;
+        }
+        spans.push_back(MessageSpan{static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin), EmojiManager::INVALID_EMOJI_ID});
+    }
+
+    void Tokenize(std::string_view text, std::vector<MessageSpan>& outSpans)
+    {
+        outSpans.clear();
+
+        size_t textStart = 0;
+        size_t pos = text.find(':');
+        while (pos != std::string_view::npos) {
+            size_t endPos = text.find(':', pos + 1);
+            if (endPos == std::string_view::npos) break;
+
+            uint32_t emojiId = EmojiManager::FindEmoji(text.substr(pos, endPos - pos + 1));
+            if (emojiId == EmojiManager::INVALID_EMOJI_ID) {
+                // Not a shortcode; the closing ':' may still open the next one
+                pos = endPos;
+                continue;
+            }
+
+            AppendText(outSpans, textStart, pos);
+            outSpans.push_back(MessageSpan{static_cast<uint32_t>(pos), static_cast<uint32_t>(endPos - pos + 1), emojiId});
+            textStart = endPos + 1;
+            pos = text.find(':', textStart);
+        }
+
+        AppendText(outSpans, textStart, text.size());
+    }
+}
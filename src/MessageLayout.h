@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// A run of a message: either plain text or one resolved emoji
+struct MessageSpan {
+    uint32_t begin;   // Byte offset into the message text
+    uint32_t length;
+    uint32_t emojiId; // EmojiManager::INVALID_EMOJI_ID for plain text
+};
+
+namespace MessageLayout {
+    // Splits text into text and :shortcode: emoji spans, resolving shortcodes against the emoji index
+    void Tokenize(std::string_view text, std::vector<MessageSpan>& outSpans);
+}
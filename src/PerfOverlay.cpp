@@ -0,0 +1,165 @@
+#include "PerfOverlay.h"
+#include "imgui.h"
+#include "debug/GAllocCounter.h"
+#include "debug/GMetrics.h"
+#include <chrono>
+#include <vector>
+
+namespace PerfOverlay {
+    const double REFRESH_SECONDS = 1.0; // Numbers cover the last window and update once per window
+    const size_t MAX_PLOT_BUCKETS = 48;
+
+    static bool visible = false;
+
+    // Window of a cumulative histogram between two refreshes
+    struct HistogramWindow {
+        GMetricHistogram* histogram;
+        GMetricHistogramSnapshot previous;
+        GMetricHistogramSnapshot window;
+    };
+
+    // Per-second rate of a counter
+    struct CounterRate {
+        GMetricCounter* counter;
+        uint64_t previous = 0;
+        double perSecond = 0.0;
+    };
+
+    static HistogramWindow cpuFrameTime{&GMetrics::histogram("frame.cpu_ns")};
+    static HistogramWindow presentTime{&GMetrics::histogram("frame.present_ns")};
+    static HistogramWindow frameAllocations{&GMetrics::histogram("frame.allocations")};
+    static HistogramWindow frameAllocatedBytes{&GMetrics::histogram("frame.allocated_bytes")};
+    static HistogramWindow pacerLateness{&GMetrics::histogram("frame.pacer_lateness_ns")};
+    static CounterRate textureHits{&GMetrics::counter("emoji.texture_hits")};
+    static CounterRate textureMisses{&GMetrics::counter("emoji.texture_misses")};
+    static CounterRate logRecords{&GMetrics::counter("glog.records")};
+    static CounterRate missedDeadlines{&GMetrics::counter("frame.pacer_missed")};
+    static GMetricGauge& textureResidentBytes = GMetrics::gauge("emoji.texture_resident_bytes");
+    static GMetricGauge& textureBudgetBytes = GMetrics::gauge("emoji.texture_budget_bytes");
+    static GMetricGauge& logQueueDepth = GMetrics::gauge("glog.queue_depth");
+    static GMetricGauge& logDropped = GMetrics::gauge("glog.dropped");
+    static std::vector<float> plotCounts;
+    static float plotMinMs = 0.0f;
+    static float plotMaxMs = 0.0f;
+    static std::chrono::steady_clock::time_point lastRefresh;
+
+    static void Refresh(double seconds)
+    {
+        GMetrics::sampleGauges(); // The GLog gauges are only sampled on demand
+        for (HistogramWindow* histogram : {&cpuFrameTime, &presentTime, &frameAllocations, &frameAllocatedBytes, &pacerLateness}) {
+            GMetricHistogramSnapshot current = histogram->histogram->snapshot();
+            histogram->window = current.since(histogram->previous);
+            histogram->previous = std::move(current);
+        }
+        for (CounterRate* rate : {&textureHits, &textureMisses, &logRecords, &missedDeadlines}) {
+            uint64_t current = rate->counter->get();
+            rate->perSecond = static_cast<double>(current - rate->previous) / seconds;
+            rate->previous = current;
+        }
+
+        // Present-to-present distribution, from the first to the last non-empty bucket
+        const std::vector<uint64_t>& counts = presentTime.window.counts;
+        size_t first = 0, last = 0;
+        bool any = false;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (!counts[i]) continue;
+            if (!any) first = i;
+            last = i;
+            any = true;
+        }
+        plotCounts.clear();
+        if (!any) return;
+        if (last - first >= MAX_PLOT_BUCKETS) first = last - MAX_PLOT_BUCKETS + 1; // Keep the slow tail visible
+        for (size_t i = first; i <= last; ++i) plotCounts.push_back(static_cast<float>(counts[i]));
+        plotMinMs = static_cast<float>(GMetricHistogram::bucketLowerBound(first) / 1e6);
+        plotMaxMs = static_cast<float>(GMetricHistogram::bucketUpperBound(last) / 1e6);
+    }
+
+    static void PercentileRow(const char* label, const GMetricHistogramSnapshot& window)
+    {
+        ImGui::Text("%-8s p50 %6.2f  p95 %6.2f  p99 %6.2f ms", label,
+                    window.percentile(50) / 1e6, window.percentile(95) / 1e6, window.percentile(99) / 1e6);
+    }
+
+    // Baselines for the first window after the overlay is shown, so it covers a real
+    // REFRESH_SECONDS instead of everything since startup or since it was hidden
+    static void StartWindow()
+    {
+        for (HistogramWindow* histogram : {&cpuFrameTime, &presentTime, &frameAllocations, &frameAllocatedBytes, &pacerLateness}) {
+            histogram->previous = histogram->histogram->snapshot();
+            histogram->window = GMetricHistogramSnapshot();
+        }
+        for (CounterRate* rate : {&textureHits, &textureMisses, &logRecords, &missedDeadlines}) {
+            rate->previous = rate->counter->get();
+            rate->perSecond = 0.0;
+        }
+        plotCounts.clear();
+        lastRefresh = std::chrono::steady_clock::now();
+    }
+
+    void Render()
+    {
+        if (!visible) return;
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastRefresh).count();
+        if (elapsed >= REFRESH_SECONDS) {
+            Refresh(elapsed);
+            lastRefresh = now;
+        }
+
+        ImGuiIO& io = ImGui::GetIO();
+        ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - 10.0f, 10.0f), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+        ImGui::SetNextWindowBgAlpha(0.85f);
+        ImGui::Begin("Performance", &visible,
+                     ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+                         ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+
+        ImGui::Text("Frames: %llu in the last second", static_cast<unsigned long long>(presentTime.window.count));
+        PercentileRow("CPU", cpuFrameTime.window);
+        PercentileRow("Present", presentTime.window);
+        if (!plotCounts.empty()) {
+            char range[64];
+            snprintf(range, sizeof(range), "%.1f - %.1f ms", plotMinMs, plotMaxMs);
+            ImGui::PlotHistogram("##PresentHistogram", plotCounts.data(), static_cast<int>(plotCounts.size()), 0, range,
+                                 0.0f, FLT_MAX, ImVec2(320.0f, 60.0f));
+        }
+
+        ImGui::Text("Pacing: %.1f missed/s, lateness mean %.2f  p99 %.2f ms", missedDeadlines.perSecond,
+                    pacerLateness.window.mean() / 1e6, pacerLateness.window.percentile(99) / 1e6);
+
+        ImGui::Separator();
+        double lookups = textureHits.perSecond + textureMisses.perSecond;
+        ImGui::Text("Textures: %.0f hits/s, %.0f misses/s (%.1f%% hit)", textureHits.perSecond, textureMisses.perSecond,
+                    lookups > 0.0 ? 100.0 * textureHits.perSecond / lookups : 100.0);
+        ImGui::Text("Resident: %.1f / %.1f MB", textureResidentBytes.get() / (1024.0 * 1024.0),
+                    textureBudgetBytes.get() / (1024.0 * 1024.0));
+
+        ImGui::Separator();
+        ImGui::Text("Log: %.0f records/s, queue %.0f, dropped %.0f", logRecords.perSecond,
+                    logQueueDepth.get(), logDropped.get());
+
+        ImGui::Separator();
+        if (GAllocCounter::isEnabled()) {
+            ImGui::Text("Allocations/frame: p50 %llu  p99 %llu  mean %.1f",
+                        static_cast<unsigned long long>(frameAllocations.window.percentile(50)),
+                        static_cast<unsigned long long>(frameAllocations.window.percentile(99)), frameAllocations.window.mean());
+            ImGui::Text("Allocated bytes/frame: mean %.0f  p99 %llu", frameAllocatedBytes.window.mean(),
+                        static_cast<unsigned long long>(frameAllocatedBytes.window.percentile(99)));
+        } else {
+            ImGui::TextDisabled("Allocations/frame: build with LMS_COUNT_ALLOCATIONS");
+        }
+        ImGui::End();
+    }
+
+    void ToggleVisible()
+    {
+        visible = !visible;
+        if (visible) StartWindow();
+    }
+
+    bool IsVisible()
+    {
+        return visible;
+    }
+}
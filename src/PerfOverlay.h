@@ -0,0 +1,8 @@
+#pragma once
+
+// Diagnostics window fed from the GMetrics registry: frame times, texture cache, logging and allocations
+namespace PerfOverlay {
+    void Render(); // Draws nothing while hidden
+    void ToggleVisible();
+    bool IsVisible();
+}
@@ -0,0 +1,146 @@
+#include "RenderScheduler.h"
+#include "debug/GMetrics.h"
+#include "debug/GTrace.h"
+#include "imgui.h"
+#include <GLFW/glfw3.h>
+#include <atomic>
+
+namespace RenderScheduler {
+    GLFWwindow* mainWindow = nullptr;
+    std::atomic<bool> redrawRequested(true); // The first frame is always drawn
+    std::atomic<uint64_t> frameCount(0);
+    double burstEnd = 0.0; // glfwGetTime() until which frames are rendered without a request
+    bool resumedFromIdle = false;
+
+    GLFWcursorposfun previousCursorPos = nullptr;
+    GLFWmousebuttonfun previousMouseButton = nullptr;
+    GLFWscrollfun previousScroll = nullptr;
+    GLFWkeyfun previousKey = nullptr;
+    GLFWcharfun previousChar = nullptr;
+    GLFWcursorenterfun previousCursorEnter = nullptr;
+    GLFWwindowsizefun previousWindowSize = nullptr;
+    GLFWwindowrefreshfun previousWindowRefresh = nullptr;
+
+    static void CursorPosCallback(GLFWwindow* window, double x, double y)
+    {
+        NotifyInput();
+        if (previousCursorPos) previousCursorPos(window, x, y);
+    }
+
+    static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+    {
+        NotifyInput();
+        if (previousMouseButton) previousMouseButton(window, button, action, mods);
+    }
+
+    static void ScrollCallback(GLFWwindow* window, double xOffset, double yOffset)
+    {
+        NotifyInput();
+        if (previousScroll) previousScroll(window, xOffset, yOffset);
+    }
+
+    static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+    {
+        NotifyInput();
+        if (previousKey) previousKey(window, key, scancode, action, mods);
+    }
+
+    static void CharCallback(GLFWwindow* window, unsigned int codepoint)
+    {
+        NotifyInput();
+        if (previousChar) previousChar(window, codepoint);
+    }
+
+    static void CursorEnterCallback(GLFWwindow* window, int entered)
+    {
+        NotifyInput();
+        if (previousCursorEnter) previousCursorEnter(window, entered);
+    }
+
+    static void WindowSizeCallback(GLFWwindow* window, int width, int height)
+    {
+        NotifyInput();
+        if (previousWindowSize) previousWindowSize(window, width, height);
+    }
+
+    static void WindowRefreshCallback(GLFWwindow* window)
+    {
+        // The contents were damaged, e.g. uncovered by another window
+        RequestRedraw();
+        if (previousWindowRefresh) previousWindowRefresh(window);
+    }
+
+    void Init(GLFWwindow* window)
+    {
+        mainWindow = window;
+        previousCursorPos = glfwSetCursorPosCallback(window, CursorPosCallback);
+        previousMouseButton = glfwSetMouseButtonCallback(window, MouseButtonCallback);
+        previousScroll = glfwSetScrollCallback(window, ScrollCallback);
+        previousKey = glfwSetKeyCallback(window, KeyCallback);
+        previousChar = glfwSetCharCallback(window, CharCallback);
+        previousCursorEnter = glfwSetCursorEnterCallback(window, CursorEnterCallback);
+        previousWindowSize = glfwSetWindowSizeCallback(window, WindowSizeCallback);
+        previousWindowRefresh = glfwSetWindowRefreshCallback(window, WindowRefreshCallback);
+        NotifyInput(); // ImGui needs a few frames to lay out the first windows
+    }
+
+    void Shutdown()
+    {
+        // Stops worker threads from posting to a window that is going away
+        mainWindow = nullptr;
+    }
+
+    void RequestRedraw()
+    {
+        // Only the first request since the last frame needs to wake the loop
+        if (redrawRequested.exchange(true, std::memory_order_acq_rel)) return;
+        if (mainWindow) glfwPostEmptyEvent();
+    }
+
+    void NotifyInput()
+    {
+        burstEnd = glfwGetTime() + INPUT_BURST_SECONDS;
+    }
+
+    bool WaitForFrame()
+    {
+        TRACE_SCOPE("WaitForFrame");
+        resumedFromIdle = false;
+        while (true) {
+            if (glfwWindowShouldClose(mainWindow)) return false;
+
+            // Cleared before rendering, so a request made while this frame is built wakes the next wait
+            bool minimized = glfwGetWindowAttrib(mainWindow, GLFW_ICONIFIED) == GLFW_TRUE;
+            if (!minimized && (redrawRequested.exchange(false, std::memory_order_acq_rel) || glfwGetTime() < burstEnd)) {
+                // Pick up input that arrived since the last frame without blocking
+                glfwPollEvents();
+                break;
+            }
+
+            // A focused text field gets a frame per caret blink; everything else sleeps until an event.
+            // ImGui keeps the field active when the window loses focus, so the window has to be focused too.
+            resumedFromIdle = true;
+            bool focused = glfwGetWindowAttrib(mainWindow, GLFW_FOCUSED) == GLFW_TRUE;
+            if (!minimized && focused && ImGui::GetCurrentContext() && ImGui::GetIO().WantTextInput) {
+                glfwWaitEventsTimeout(CARET_BLINK_SECONDS);
+                break;
+            }
+            glfwWaitEvents();
+        }
+
+        frameCount.fetch_add(1, std::memory_order_relaxed);
+        static GMetricCounter& framesRendered = GMetrics::counter("frame.rendered");
+        framesRendered.add();
+        return !glfwWindowShouldClose(mainWindow);
+    }
+
+    bool ResumedFromIdle()
+    {
+        return resumedFromIdle;
+    }
+
+    uint64_t GetFrameCount()
+    {
+        return frameCount.load(std::memory_order_relaxed);
+    }
+}
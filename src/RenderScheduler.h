@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+struct GLFWwindow;
+
+// On-demand rendering. The main loop sleeps in glfwWaitEvents until something
+// asks for a frame: input (followed by a short burst so ImGui animations and
+// hover states can finish) or a RequestRedraw() from any thread.
+namespace RenderScheduler {
+    const double INPUT_BURST_SECONDS = 0.5;  // Keep rendering this long after the last input
+    const double CARET_BLINK_SECONDS = 0.4;  // Wake-up interval while a text field is active, for the caret
+
+    // Chains input callbacks onto the window. Call before ImGui_ImplGlfw_InitForOpenGL
+    // so the ImGui backend chains on top of them.
+    void Init(GLFWwindow* window);
+    void Shutdown();
+
+    // Thread-safe: marks the UI dirty and wakes the main loop
+    void RequestRedraw();
+    // Main thread: keeps rendering for INPUT_BURST_SECONDS, e.g. after a window event
+    void NotifyInput();
+
+    // Processes events and blocks until a frame should be rendered. False once the window should close.
+    bool WaitForFrame();
+    uint64_t GetFrameCount(); // Frames WaitForFrame() let through, thread-safe
+    // True if the last WaitForFrame() slept waiting for events, so this frame does not follow the previous one
+    bool ResumedFromIdle();
+}
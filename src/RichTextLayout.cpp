@@ -0,0 +1,174 @@
+#include "RichTextLayout.h"
+#include "EmojiManager.h"
+#include "imgui.h"
+#include <algorithm>
+
+namespace RichText {
+    // Decodes one UTF-8 sequence; malformed bytes come out as U+FFFD, one byte at a time
+    static unsigned int DecodeUtf8(const char* text, const char* end, int& length)
+    {
+        unsigned char lead = static_cast<unsigned char>(text[0]);
+        int expected = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (expected == 0 || end - text < expected) {
+            length = 1;
+            return 0xFFFD;
+        }
+
+        unsigned int codepoint = expected == 1 ? lead : lead & (0x7F >> expected);
+        for (int i = 1; i < expected; ++i) {
+            unsigned char next = static_cast<unsigned char>(text[i]);
+            if ((next & 0xC0) != 0x80) {
+                length = 1;
+                return 0xFFFD;
+            }
+            codepoint = (codepoint << 6) | (next & 0x3F);
+        }
+        length = expected;
+        return codepoint;
+    }
+
+    class LineBuilder {
+    public:
+        LineBuilder(const RichTextStyle& style, float wrapWidth, RichTextLayout& out)
+            : style(style), wrapWidth(wrapWidth), out(out), scale(style.fontSize / style.font->FontSize) {}
+
+        float advance(unsigned int codepoint) const
+        {
+            ImWchar glyph = codepoint <= IM_UNICODE_CODEPOINT_MAX ? static_cast<ImWchar>(codepoint) : static_cast<ImWchar>(0xFFFD);
+            return style.font->GetCharAdvance(glyph) * scale;
+        }
+
+        void addText(std::string_view source, uint32_t sourceBegin, uint32_t sourceEnd, bool inPrefix)
+        {
+            const char* base = source.data();
+            uint32_t pos = sourceBegin;
+            while (pos < sourceEnd) {
+                if (base[pos] == '\n') {
+                    breakLine();
+                    pos++;
+                    continue;
+                }
+
+                // A word and the spaces after it; spaces never wrap, so they may hang past the edge
+                uint32_t wordEnd = pos;
+                float wordWidth = 0.0f;
+                while (wordEnd < sourceEnd && base[wordEnd] != ' ' && base[wordEnd] != '\n') {
+                    int length = 0;
+                    wordWidth += advance(DecodeUtf8(base + wordEnd, base + sourceEnd, length));
+                    wordEnd += static_cast<uint32_t>(length);
+                }
+
+                if (x > 0.0f && x + wordWidth > wrapWidth) breakLine();
+                if (wordWidth > wrapWidth) {
+                    addLongWord(base, pos, wordEnd, inPrefix);
+                } else {
+                    appendRun(pos, wordEnd - pos, wordWidth, inPrefix);
+                }
+                contentWidth = x;
+
+                uint32_t spacesEnd = wordEnd;
+                while (spacesEnd < sourceEnd && base[spacesEnd] == ' ') spacesEnd++;
+                if (spacesEnd > wordEnd) appendRun(wordEnd, spacesEnd - wordEnd, advance(' ') * static_cast<float>(spacesEnd - wordEnd), inPrefix);
+                pos = spacesEnd;
+            }
+        }
+
+        void addEmoji(uint32_t sourceBegin, uint32_t sourceLength, uint32_t emojiId)
+        {
+            if (x > 0.0f && x + style.emojiSize > wrapWidth) breakLine();
+            out.items.push_back(RichTextItem{x, style.emojiSize, sourceBegin, sourceLength, emojiId, false});
+            x += style.emojiSize;
+            contentWidth = x;
+            lineHasEmoji = true;
+        }
+
+        void finish()
+        {
+            breakLine();
+        }
+
+    private:
+        // Extends the last text item when it continues it on the same line
+        void appendRun(uint32_t begin, uint32_t length, float width, bool inPrefix)
+        {
+            if (out.items.size() > lineFirstItem) {
+                RichTextItem& last = out.items.back();
+                if (last.emojiId == EmojiManager::INVALID_EMOJI_ID && last.inPrefix == inPrefix && last.begin + last.length == begin) {
+                    last.length += length;
+                    last.width += width;
+                    x += width;
+                    return;
+                }
+            }
+            out.items.push_back(RichTextItem{x, width, begin, length, EmojiManager::INVALID_EMOJI_ID, inPrefix});
+            x += width;
+        }
+
+        // A word wider than the line is split between characters
+        void addLongWord(const char* base, uint32_t begin, uint32_t end, bool inPrefix)
+        {
+            uint32_t runBegin = begin;
+            float runWidth = 0.0f;
+            for (uint32_t pos = begin; pos < end;) {
+                int length = 0;
+                float glyphWidth = advance(DecodeUtf8(base + pos, base + end, length));
+                if (x + runWidth + glyphWidth > wrapWidth && (x > 0.0f || runWidth > 0.0f)) {
+                    appendRun(runBegin, pos - runBegin, runWidth, inPrefix);
+                    contentWidth = x;
+                    breakLine();
+                    runBegin = pos;
+                    runWidth = 0.0f;
+                }
+                runWidth += glyphWidth;
+                pos += static_cast<uint32_t>(length);
+            }
+            appendRun(runBegin, end - runBegin, runWidth, inPrefix);
+        }
+
+        void breakLine()
+        {
+            float height = lineHasEmoji ? std::max(style.fontSize, style.emojiSize) : style.fontSize;
+            out.lines.push_back(RichTextLine{static_cast<uint32_t>(lineFirstItem), static_cast<uint32_t>(out.items.size() - lineFirstItem), out.height, height});
+            out.height += height;
+            out.width = std::max(out.width, contentWidth);
+
+            lineFirstItem = out.items.size();
+            x = 0.0f;
+            contentWidth = 0.0f;
+            lineHasEmoji = false;
+        }
+
+        const RichTextStyle& style;
+        float wrapWidth;
+        RichTextLayout& out;
+        float scale;
+
+        size_t lineFirstItem = 0;
+        float x = 0.0f;
+        float contentWidth = 0.0f; // Line width without the trailing spaces
+        bool lineHasEmoji = false;
+    };
+
+    void Layout(std::string_view prefix, std::string_view text, const std::vector<MessageSpan>& spans,
+                const RichTextStyle& style, float wrapWidth, RichTextLayout& out)
+    {
+        out.items.clear();
+        out.lines.clear();
+        out.prefix.assign(prefix.data(), prefix.size());
+        out.width = 0.0f;
+        out.height = 0.0f;
+        out.wrapWidth = wrapWidth;
+        out.style = style;
+
+        LineBuilder builder(style, std::max(wrapWidth, style.emojiSize), out);
+        builder.addText(out.prefix, 0, static_cast<uint32_t>(out.prefix.size()), true);
+        for (const MessageSpan& span : spans) {
+            if (span.emojiId == EmojiManager::INVALID_EMOJI_ID) {
+                builder.addText(text, span.begin, span.begin + span.length, false);
+            } else {
+                builder.addEmoji(span.begin, span.length, span.emojiId);
+            }
+        }
+        builder.finish();
+    }
+}
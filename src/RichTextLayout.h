@@ -0,0 +1,58 @@
+#pragma once
+#include "MessageLayout.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ImFont;
+
+// A run of text or one emoji, placed on a line
+struct RichTextItem {
+    float x;
+    float width;
+    uint32_t begin;   // Byte offset into the source string
+    uint32_t length;
+    uint32_t emojiId; // EmojiManager::INVALID_EMOJI_ID for text
+    bool inPrefix;    // Offsets are into RichTextLayout::prefix rather than the text
+};
+
+struct RichTextLine {
+    uint32_t firstItem;
+    uint32_t itemCount;
+    float y;      // Top of the line, relative to the layout
+    float height;
+};
+
+struct RichTextStyle {
+    ImFont* font = nullptr;
+    float fontSize = 0.0f;
+    float emojiSize = 0.0f;
+};
+
+// Wrapped lines of a message, ready to be drawn straight into a draw list. The
+// inputs it was built from are kept so callers can tell when it must be rebuilt.
+struct RichTextLayout {
+    std::vector<RichTextItem> items;
+    std::vector<RichTextLine> lines;
+    std::string prefix;  // Copied, e.g. "author: ", so the layout can draw it on its own
+    float width = 0.0f;  // Widest line
+    float height = 0.0f;
+
+    float wrapWidth = -1.0f;
+    RichTextStyle style;
+    uint32_t revision = 0; // Content revision the caller laid out, see ChatHistory::revision()
+
+    bool isCurrent(const RichTextStyle& currentStyle, float currentWrapWidth, uint32_t currentRevision) const {
+        return wrapWidth == currentWrapWidth && revision == currentRevision && style.font == currentStyle.font &&
+               style.fontSize == currentStyle.fontSize && style.emojiSize == currentStyle.emojiSize;
+    }
+};
+
+namespace RichText {
+    // One pass over prefix + spans: measures glyph advances through the font, breaks lines at
+    // spaces (inside words only when a word is wider than the line) and places emoji as
+    // emojiSize squares. Lines holding an emoji are as tall as it; draw items centered in their line.
+    void Layout(std::string_view prefix, std::string_view text, const std::vector<MessageSpan>& spans,
+                const RichTextStyle& style, float wrapWidth, RichTextLayout& out);
+}
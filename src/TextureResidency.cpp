@@ -0,0 +1,139 @@
+#include "TextureResidency.h"
+
+void TextureResidency::reset(uint32_t capacity)
+{
+    clear();
+    entries.assign(capacity, Entry());
+}
+
+bool TextureResidency::touch(uint32_t id)
+{
+    if (!isResident(id)) return false;
+
+    Entry& entry = entries[id];
+    entry.lastUsedFrame = currentFrame;
+    stats_.hits++;
+
+    // Pinned entries live outside the LRU list
+    if (entry.pinCount == 0 && head != id) {
+        unlink(id);
+        linkFront(id);
+    }
+    return true;
+}
+
+void TextureResidency::insert(uint32_t id, size_t bytes)
+{
+    if (id >= entries.size()) return;
+    if (entries[id].resident) remove(id);
+
+    Entry& entry = entries[id];
+    entry.resident = true;
+    entry.bytes = bytes;
+    entry.lastUsedFrame = currentFrame;
+    stats_.bytesResident += bytes;
+    stats_.entriesResident++;
+
+    if (entry.pinCount == 0) linkFront(id);
+}
+
+void TextureResidency::remove(uint32_t id)
+{
+    if (!isResident(id)) return;
+
+    Entry& entry = entries[id];
+    if (entry.pinCount == 0) unlink(id);
+    stats_.bytesResident -= entry.bytes;
+    stats_.entriesResident--;
+    entry.resident = false;
+    entry.bytes = 0;
+}
+
+void TextureResidency::pin(uint32_t id)
+{
+    if (id >= entries.size()) return;
+
+    Entry& entry = entries[id];
+    if (entry.pinCount++ == 0) {
+        stats_.entriesPinned++;
+        if (entry.resident) unlink(id);
+    }
+}
+
+void TextureResidency::unpin(uint32_t id)
+{
+    if (id >= entries.size() || entries[id].pinCount == 0) return;
+
+    Entry& entry = entries[id];
+    if (--entry.pinCount == 0) {
+        stats_.entriesPinned--;
+        if (entry.resident) {
+            entry.lastUsedFrame = currentFrame;
+            linkFront(id);
+        }
+    }
+}
+
+void TextureResidency::endFrame()
+{
+    // The tail is the least recently used entry; once it is not idle, nothing before it is either
+    while (stats_.bytesResident > stats_.bytesBudget && tail != NONE && isIdle(entries[tail])) {
+        evict(tail);
+    }
+    currentFrame++;
+}
+
+bool TextureResidency::evictOne()
+{
+    // Never evict something drawn in the current frame, its UVs are already in the draw list
+    if (tail == NONE || entries[tail].lastUsedFrame == currentFrame) return false;
+    evict(tail);
+    return true;
+}
+
+void TextureResidency::evictIdle()
+{
+    while (tail != NONE && isIdle(entries[tail])) {
+        evict(tail);
+    }
+}
+
+void TextureResidency::clear()
+{
+    for (Entry& entry : entries) {
+        entry = Entry();
+    }
+    head = NONE;
+    tail = NONE;
+    stats_.bytesResident = 0;
+    stats_.entriesResident = 0;
+    stats_.entriesPinned = 0;
+}
+
+void TextureResidency::linkFront(uint32_t id)
+{
+    Entry& entry = entries[id];
+    entry.prev = NONE;
+    entry.next = head;
+    if (head != NONE) entries[head].prev = id;
+    head = id;
+    if (tail == NONE) tail = id;
+}
+
+void TextureResidency::unlink(uint32_t id)
+{
+    Entry& entry = entries[id];
+    if (entry.prev != NONE) entries[entry.prev].next = entry.next;
+    else head = entry.next;
+    if (entry.next != NONE) entries[entry.next].prev = entry.prev;
+    else tail = entry.prev;
+    entry.prev = NONE;
+    entry.next = NONE;
+}
+
+void TextureResidency::evict(uint32_t id)
+{
+    remove(id);
+    stats_.evictions++;
+    if (onEvict) onEvict(id);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TextureResidencyStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t bytesResident = 0;
+    size_t bytesBudget = 0;
+    uint32_t entriesResident = 0;
+    uint32_t entriesPinned = 0;
+};
+
+// Tracks which textures are resident on the GPU and decides what to evict.
+//
+// Entries are addressed by a dense id (the emoji id), so lookups are an array
+// index and the LRU list is intrusive: touching an entry is O(1). Eviction is
+// driven by a byte budget, but an entry is only evicted once it has not been
+// touched for minIdleFrames frames, so anything drawn recently survives even
+// when the cache is over budget. Pinned entries are never evicted.
+class TextureResidency {
+public:
+    using EvictCallback = void (*)(uint32_t id);
+
+    void reset(uint32_t capacity);
+    void setBudget(size_t bytes) { stats_.bytesBudget = bytes; }
+    void setMinIdleFrames(uint32_t frames) { minIdleFrames = frames; }
+    void setEvictCallback(EvictCallback callback) { onEvict = callback; }
+
+    // Marks the entry as used this frame and counts a hit. Returns false if it is not resident.
+    bool touch(uint32_t id);
+    // Counts a miss: the caller queued a load for an entry that was not resident
+    void countMiss() { stats_.misses++; }
+    void insert(uint32_t id, size_t bytes);
+    void remove(uint32_t id);
+    bool isResident(uint32_t id) const { return id < entries.size() && entries[id].resident; }
+
+    void pin(uint32_t id);
+    void unpin(uint32_t id);
+
+    // Advances the frame counter and evicts idle entries while over budget
+    void endFrame();
+    // Evicts the least recently used idle entry regardless of budget, e.g. when the atlas is full
+    bool evictOne();
+    // Evicts every entry that is idle, regardless of budget
+    void evictIdle();
+    void clear(); // Hit, miss and eviction totals are kept
+
+    uint32_t frame() const { return currentFrame; }
+    const TextureResidencyStats& stats() const { return stats_; }
+    size_t memoryBytes() const { return entries.capacity() * sizeof(Entry); } // Bookkeeping, not texture memory
+
+private:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Entry {
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t lastUsedFrame = 0;
+        uint32_t pinCount = 0;
+        size_t bytes = 0;
+        bool resident = false;
+    };
+
+    void linkFront(uint32_t id);
+    void unlink(uint32_t id);
+    bool isIdle(const Entry& entry) const { return currentFrame - entry.lastUsedFrame >= minIdleFrames; }
+    void evict(uint32_t id);
+
+    std::vector<Entry> entries;
+    uint32_t head = NONE; // Most recently used
+    uint32_t tail = NONE; // Least recently used
+    uint32_t currentFrame = 0;
+    uint32_t minIdleFrames = 120;
+    EvictCallback onEvict = nullptr;
+    TextureResidencyStats stats_;
+};
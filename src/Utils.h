@@ -1,5 +0,0 @@
-#pragma once
-
-namespace Utils {
-    void LimitFrameRate(int targetFPS);
-}
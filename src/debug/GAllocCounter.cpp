@@ -0,0 +1,156 @@
+#include "GAllocCounter.h"
+#include "GAllocProfiler.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef LMS_COUNT_ALLOCATIONS
+
+namespace {
+    // One per thread, written only by its thread and never freed, so exited threads still add up.
+    // Allocated with calloc: anything that went through operator new would recurse.
+    struct ThreadCounters {
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> frees;
+        ThreadCounters* next;
+        uint32_t untilSample;
+    };
+
+    std::atomic<ThreadCounters*> allThreads{nullptr};
+    thread_local ThreadCounters* threadCounters = nullptr; // Constant-initialized, so no TLS guard runs in operator new
+}
+
+static ThreadCounters* GetThreadCounters() {
+    if (threadCounters) return threadCounters;
+
+    ThreadCounters* counters = static_cast<ThreadCounters*>(std::calloc(1, sizeof(ThreadCounters)));
+    if (!counters) return nullptr;
+    counters->untilSample = ALLOC_SAMPLE_INTERVAL;
+    counters->next = allThreads.load(std::memory_order_relaxed);
+    while (!allThreads.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed)) {}
+    threadCounters = counters;
+    return counters;
+}
+
+// Single writer: a load and a store instead of a locked add
+static void Bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+static void CountAllocation(std::size_t size) {
+    ThreadCounters* counters = GetThreadCounters();
+    if (!counters) return;
+    Bump(counters->allocations, 1);
+    Bump(counters->bytes, size);
+#ifdef LMS_PROFILE_ALLOCATIONS
+    if (--counters->untilSample == 0) {
+        counters->untilSample = ALLOC_SAMPLE_INTERVAL;
+        GAllocProfiler::recordSample(size);
+    }
+#endif
+}
+
+static void CountFree(void* pointer) {
+    if (!pointer) return;
+    if (ThreadCounters* counters = GetThreadCounters()) Bump(counters->frees, 1);
+}
+
+static void* CountedAlloc(std::size_t size) {
+    CountAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+static void* CountedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    CountAllocation(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    std::size_t rounded = ((size ? size : 1) + align - 1) / align * align; // aligned_alloc wants a multiple
+    return std::aligned_alloc(align, rounded);
+#endif
+}
+
+static void CountedFree(void* pointer) {
+    CountFree(pointer);
+    std::free(pointer);
+}
+
+static void AlignedFree(void* pointer) {
+    CountFree(pointer);
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void* operator new(std::size_t size) {
+    void* pointer = CountedAlloc(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    void* pointer = CountedAlloc(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pointer = CountedAlignedAlloc(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* pointer = CountedAlignedAlloc(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+
+void operator delete(void* pointer) noexcept { CountedFree(pointer); }
+void operator delete[](void* pointer) noexcept { CountedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { CountedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { CountedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { CountedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { CountedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { AlignedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(pointer); }
+
+bool GAllocCounter::isEnabled() {
+    return true;
+}
+
+GAllocStats GAllocCounter::get() {
+    GAllocStats stats;
+    for (ThreadCounters* counters = allThreads.load(std::memory_order_acquire); counters; counters = counters->next) {
+        stats.allocations += counters->allocations.load(std::memory_order_relaxed);
+        stats.bytes += counters->bytes.load(std::memory_order_relaxed);
+        stats.frees += counters->frees.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+#else
+
+bool GAllocCounter::isEnabled() {
+    return false;
+}
+
+GAllocStats GAllocCounter::get() {
+    return GAllocStats{};
+}
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+struct GAllocStats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+};
+
+// ✅ Global heap allocation totals. Only counted when the build defines LMS_COUNT_ALLOCATIONS
+// (CMake option of the same name, also set by LMS_PROFILE_ALLOCATIONS), which replaces the
+// global operator new and delete. Every thread counts into its own block, so counting never
+// contends; get() sums the blocks, including those of threads that have exited.
+class GAllocCounter {
+public:
+    static bool isEnabled();
+    static GAllocStats get(); // Since startup, all threads
+};
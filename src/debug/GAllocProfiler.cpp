@@ -0,0 +1,150 @@
+#include "GAllocProfiler.h"
+#include "GAllocCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#ifdef LMS_PROFILE_ALLOCATIONS
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <execinfo.h>
+#endif
+
+namespace {
+    // Open-addressed, insert-only: a slot is claimed by swapping its hash in, then
+    // filled, then marked ready. Readers skip slots that are not ready yet.
+    struct Callsite {
+        std::atomic<uint64_t> hash;
+        std::atomic<bool> ready;
+        void* frames[GAllocProfiler::MAX_FRAMES];
+        uint32_t frameCount;
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> bytes;
+    };
+
+    Callsite callsites[GAllocProfiler::MAX_CALLSITES];
+    std::atomic<uint64_t> droppedSamples{0};
+    thread_local bool inProfiler = false; // Stack capture may allocate on its first use
+    const int SKIPPED_FRAMES = 1;         // recordSample; inlining decides how many operator new frames follow, so they stay
+}
+
+static uint32_t CaptureStack(void** frames, uint32_t maxFrames) {
+#ifdef _WIN32
+    return CaptureStackBackTrace(SKIPPED_FRAMES, maxFrames, frames, nullptr);
+#else
+    void* all[GAllocProfiler::MAX_FRAMES + SKIPPED_FRAMES];
+    int captured = backtrace(all, static_cast<int>(maxFrames) + SKIPPED_FRAMES);
+    uint32_t count = captured > SKIPPED_FRAMES ? static_cast<uint32_t>(captured - SKIPPED_FRAMES) : 0;
+    std::copy(all + SKIPPED_FRAMES, all + SKIPPED_FRAMES + count, frames);
+    return count;
+#endif
+}
+
+void GAllocProfiler::recordSample(size_t bytes) {
+    if (inProfiler) return;
+    inProfiler = true;
+
+    void* frames[MAX_FRAMES];
+    uint32_t frameCount = CaptureStack(frames, MAX_FRAMES);
+
+    // FNV-1a over the return addresses; 0 marks an empty slot
+    uint64_t hash = 1469598103934665603ull;
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+    }
+    if (hash == 0) hash = 1;
+
+    Callsite* site = nullptr;
+    for (size_t probe = 0; probe < MAX_CALLSITES; ++probe) {
+        Callsite& candidate = callsites[(hash + probe) % MAX_CALLSITES];
+        uint64_t existing = candidate.hash.load(std::memory_order_acquire);
+        if (existing == 0 && candidate.hash.compare_exchange_strong(existing, hash, std::memory_order_acq_rel)) {
+            std::copy(frames, frames + frameCount, candidate.frames);
+            candidate.frameCount = frameCount;
+            candidate.ready.store(true, std::memory_order_release);
+            site = &candidate;
+            break;
+        }
+        if (existing == hash) {
+            site = &candidate;
+            break;
+        }
+    }
+
+    if (site) {
+        site->allocations.fetch_add(ALLOC_SAMPLE_INTERVAL, std::memory_order_relaxed);
+        site->bytes.fetch_add(static_cast<uint64_t>(bytes) * ALLOC_SAMPLE_INTERVAL, std::memory_order_relaxed);
+    } else {
+        droppedSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+    inProfiler = false;
+}
+
+bool GAllocProfiler::isEnabled() {
+    return true;
+}
+
+bool GAllocProfiler::writeReport(const std::string& path, size_t maxCallsites) {
+    // The report allocates; keep those allocations out of the profile
+    inProfiler = true;
+    std::vector<const Callsite*> sites;
+    for (const Callsite& site : callsites) {
+        if (site.ready.load(std::memory_order_acquire)) sites.push_back(&site);
+    }
+    std::sort(sites.begin(), sites.end(), [](const Callsite* a, const Callsite* b) {
+        return a->bytes.load(std::memory_order_relaxed) > b->bytes.load(std::memory_order_relaxed);
+    });
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        inProfiler = false;
+        return false;
+    }
+
+    GAllocStats totals = GAllocCounter::get();
+    std::fprintf(file, "Allocations: %llu (%llu bytes), frees: %llu\n", static_cast<unsigned long long>(totals.allocations),
+                 static_cast<unsigned long long>(totals.bytes), static_cast<unsigned long long>(totals.frees));
+    std::fprintf(file, "Callsites: %zu, sampled 1 in %u, dropped samples: %llu\n\n", sites.size(), ALLOC_SAMPLE_INTERVAL,
+                 static_cast<unsigned long long>(droppedSamples.load(std::memory_order_relaxed)));
+
+    size_t shown = std::min(sites.size(), maxCallsites);
+    for (size_t i = 0; i < shown; ++i) {
+        const Callsite& site = *sites[i];
+        std::fprintf(file, "#%zu  ~%llu allocations, ~%llu bytes\n", i + 1,
+                     static_cast<unsigned long long>(site.allocations.load(std::memory_order_relaxed)),
+                     static_cast<unsigned long long>(site.bytes.load(std::memory_order_relaxed)));
+#ifdef _WIN32
+        // Raw addresses; resolve them against the PDB with a debugger or addr2line-style tool
+        for (uint32_t frame = 0; frame < site.frameCount; ++frame) std::fprintf(file, "    %p\n", site.frames[frame]);
+#else
+        char** symbols = backtrace_symbols(site.frames, static_cast<int>(site.frameCount));
+        for (uint32_t frame = 0; frame < site.frameCount; ++frame) {
+            std::fprintf(file, "    %s\n", symbols ? symbols[frame] : "?");
+        }
+        std::free(symbols);
+#endif
+        std::fprintf(file, "\n");
+    }
+
+    std::fclose(file);
+    inProfiler = false;
+    return true;
+}
+
+#else
+
+void GAllocProfiler::recordSample(size_t) {}
+
+bool GAllocProfiler::isEnabled() {
+    return false;
+}
+
+bool GAllocProfiler::writeReport(const std::string&, size_t) {
+    return false;
+}
+
+#endif
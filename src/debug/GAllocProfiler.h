@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ✅ Per-callsite allocation profile. Only active when the build defines LMS_PROFILE_ALLOCATIONS
+// (CMake option of the same name). Every ALLOC_SAMPLE_INTERVAL-th allocation of a thread captures
+// its stack and is charged to that stack, weighted by the interval, so the per-callsite numbers
+// are estimates while the totals from GAllocCounter are exact.
+inline uint32_t ALLOC_SAMPLE_INTERVAL = 64;
+
+class GAllocProfiler {
+public:
+    static constexpr size_t MAX_FRAMES = 16;
+    static constexpr size_t MAX_CALLSITES = 4096; // Samples from further stacks are counted as dropped
+
+    static bool isEnabled();
+
+    // ✅ Writes the totals and the callsites with the most sampled bytes, symbolized where the
+    // platform can (Linux needs -rdynamic, which the CMake option adds). Returns false if the
+    // profiler is off or the file cannot be written.
+    static bool writeReport(const std::string& path, size_t maxCallsites = 40);
+
+    // ✅ Called from operator new on sampled allocations; not for other callers
+    static void recordSample(size_t bytes);
+};
@@ -2,31 +2,24 @@
 #include "GLogUtils.h"
 #include <fmt/core.h>
 
-/*
-    %Y → Year
-    %m → Month
-    %d → Day
-    %H → Hour
-    %M → Minute
-    %S → Second
-    %e → Millisecond
-    %l → Log level
-    %v → Log message
-    %t → Thread ID
-    %n → Logger name
-    %^ → Starts color formatting
-    %$ → Resets color formatting
-*/
-
 std::mutex GLog::logMutex;
-std::queue<std::string> GLog::logQueue;
-std::condition_variable GLog::logCondition;
 std::thread GLog::workerThread;
-bool GLog::stopWorker = false;
+std::atomic<bool> GLog::stopWorker = false;
 std::atomic<bool> GLog::isInitialized = false;
 
+std::unique_ptr<GLogRing> GLog::ring;
+std::mutex GLog::workerMutex;
+std::condition_variable GLog::workerWake;
+std::atomic<bool> GLog::workerSleeping = false;
+std::atomic<size_t> GLog::consumedCount = 0;
+std::atomic<size_t> GLog::droppedOldestCount = 0;
+std::atomic<size_t> GLog::droppedCount = 0;
+std::atomic<GLogOverflowPolicy> GLog::overflowPolicy = LOG_OVERFLOW_POLICY;
+
 std::vector<std::shared_ptr<GLogSink>> GLog::sinks;
 
+fmt::memory_buffer GLog::messageBuffer;
+
 void GLog::init(const std::string& filename) {
 
     if (isInitialized.load()) {
@@ -35,7 +28,9 @@ void GLog::init(const std::string& filename) {
     }
 
     std::cout << "[GLog] Creating file and console sinks..." << std::endl;
+    // ✅ The file keeps everything GLog::setLogLevel lets through, the console shows INFO and up
     auto fileSink = std::make_shared<FileSink>(filename);
+    fileSink->setPattern("[%Y-%m-%d %H:%M:%S.%e] [%t] [%l] [%s:%#] %v");
     auto consoleSink = std::make_shared<ConsoleSink>();
 
     if (!fileSink || !fileSink->isOpen()) {
@@ -48,6 +43,14 @@ void GLog::init(const std::string& filename) {
     try {
         addSink(fileSink);
         addSink(consoleSink);
+        if (ENABLE_BINARY_LOG) {
+            auto binarySink = std::make_shared<BinaryFileSink>(std::filesystem::path(filename).replace_extension(".glb").string());
+            if (binarySink->isOpen()) addSink(binarySink);
+        }
+        if (ENABLE_JSON_LOG) {
+            auto jsonSink = std::make_shared<JsonLinesSink>(std::filesystem::path(filename).replace_extension(".jsonl").string());
+            if (jsonSink->isOpen()) addSink(jsonSink);
+        }
     } catch (const std::exception& e) {
         std::cerr << "[GLog] ERROR: Exception in addSink(): " << e.what() << std::endl;
     } catch (...) {
@@ -57,11 +60,19 @@ void GLog::init(const std::string& filename) {
     std::cout << "[GLog] Sinks added successfully. Total sinks: " << sinks.size() << std::endl;
 
     if (ENABLE_ASYNC) {
-        stopWorker = false;
+        // ✅ The ring is kept across close()/init() so a late producer never sees it freed
+        // consumedCount and droppedOldestCount keep counting with it, flush() compares them to its positions
+        if (!ring) ring = std::make_unique<GLogRing>(LOG_QUEUE_CAPACITY);
+        droppedCount.store(0);
+        overflowPolicy.store(LOG_OVERFLOW_POLICY);
+        stopWorker.store(false);
         workerThread = std::thread(workerLoop);
-        std::cout << "[GLog] Async logging thread started!" << std::endl;
+        std::cout << "[GLog] Async logging thread started (" << ring->capacity() << " slots)!" << std::endl;
     }
 
+    GMetrics::sampledGauge("glog.queue_depth", [] { return static_cast<double>(getQueueDepth()); });
+    GMetrics::sampledGauge("glog.dropped", [] { return static_cast<double>(getDroppedCount()); });
+
     isInitialized.store(true);
     std::cout << "[GLog] Initialization complete." << std::endl;
 }
@@ -91,113 +102,228 @@ void GLog::addSink(std::shared_ptr<GLogSink> sink) {
 
 
 void GLog::setLogLevel(GLogLevel level) {
-    CURRENT_LOG_LEVEL = level;
+    CURRENT_LOG_LEVEL.store(level, std::memory_order_relaxed);
 }
 
-bool GLog::shouldLog(GLogLevel level) {
-    return static_cast<int>(level) >= static_cast<int>(CURRENT_LOG_LEVEL);
+// ✅ The pattern is compiled once here instead of being re-parsed for every line
+void GLog::setPattern(const std::string& pattern) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    for (auto& sink : sinks) {
+        if (sink) sink->setPattern(pattern);
+    }
 }
 
-std::string GLog::getTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t nowTime = std::chrono::system_clock::to_time_t(now);
-    std::tm localTime;
-
-    #ifdef _WIN32
-        localtime_s(&localTime, &nowTime);
-    #else
-        localtime_r(&nowTime, &localTime);
-    #endif
-
-    std::ostringstream oss;
-    oss << std::put_time(&localTime, "[%Y-%m-%d %H:%M:%S]");
-    return oss.str();
+int64_t GLog::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
-std::string GLog::logLevelToString(GLogLevel level) {
-    switch (level) {
-        case GLogLevel::GLOG_INFO: return "INFO";
-        case GLogLevel::GLOG_WARN: return "WARNING";
-        case GLogLevel::GLOG_ERROR: return "ERROR";
-        case GLogLevel::GLOG_DEBUG: return "DEBUG";
-        default: return "UNKNOWN";
-    }
+uint64_t GLog::currentThreadId() {
+    // ✅ Small sequential ids are cheaper to fetch and easier to read than std::thread::id
+    static std::atomic<uint64_t> nextThreadId{1};
+    thread_local uint64_t threadId = nextThreadId.fetch_add(1);
+    return threadId;
 }
 
-void GLog::workerLoop() {
-    std::cout << "[GLog] Worker thread started.\n";
+void GLog::setOverflowPolicy(GLogOverflowPolicy policy) {
+    overflowPolicy.store(policy);
+}
 
-    while (true) {
-        std::unique_lock<std::mutex> lock(logMutex);
-        logCondition.wait(lock, [] { return !logQueue.empty() || stopWorker; });
+size_t GLog::getDroppedCount() {
+    return droppedCount.load();
+}
 
-        if (stopWorker) {
-            std::cout << "[GLog] Worker thread stopping.\n";
-            break;  // ✅ Stop the loop immediately
-        }
+size_t GLog::getQueueDepth() {
+    if (!ring) return 0;
+    size_t done = consumedCount.load(std::memory_order_acquire) + droppedOldestCount.load(std::memory_order_acquire);
+    size_t claimed = ring->claimedCount();
+    return claimed > done ? claimed - done : 0;
+}
 
-        while (!logQueue.empty()) {
-            std::string logEntry = logQueue.front();
-            logQueue.pop();
+void GLog::wakeWorker() {
+    // ✅ Pairs with the fence in workerLoop: either the worker sees the new record
+    // before sleeping or we see it sleeping and wake it. notify_one only costs a
+    // syscall when the worker is actually asleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (workerSleeping.load(std::memory_order_relaxed)) {
+        workerWake.notify_one();
+    }
+}
 
-            for (auto& sink : sinks) {
-                if (sink) {
-                    sink->write(logEntry);
+GLogSlot* GLog::claimSlot(size_t& outPosition) {
+    while (true) {
+        GLogSlot* slot = ring->tryClaim(outPosition);
+        if (slot) return slot;
+
+        switch (overflowPolicy.load(std::memory_order_relaxed)) {
+            case GLogOverflowPolicy::GLOG_DROP_NEWEST:
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+
+            case GLogOverflowPolicy::GLOG_DROP_OLDEST: {
+                size_t oldestPosition;
+                GLogSlot* oldest = ring->tryPop(oldestPosition);
+                if (oldest) {
+                    ring->release(oldest, oldestPosition);
+                    droppedOldestCount.fetch_add(1, std::memory_order_relaxed);
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
                 } else {
-                    std::cerr << "[GLog] ERROR: Null sink in workerLoop!\n";
+                    std::this_thread::yield(); // The oldest slot is still being written by its producer
                 }
+                break;
             }
+
+            case GLogOverflowPolicy::GLOG_BLOCK:
+            default:
+                if (stopWorker.load(std::memory_order_relaxed)) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr; // Nobody is left to make room
+                }
+                wakeWorker();
+                std::this_thread::yield();
+                break;
         }
     }
-
-    std::cout << "[GLog] Worker thread exited cleanly.\n";
 }
 
-void GLog::rotateLogFile() {
-    std::filesystem::path logPath("glog.txt");
+void GLog::writeMessage(GLogLevel level, GLogSourceLocation source, std::string_view message, int64_t timestampNs, uint64_t threadId) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    GLogRecord record{level, false, timestampNs, threadId, source, {}, 0, message};
+    dispatch(record, nullptr);
+}
 
-    if (!std::filesystem::exists(logPath)) return;
+void GLog::writeSlot(const GLogSlot& slot) {
+    std::lock_guard<std::mutex> lock(logMutex);
 
-    size_t logSize = std::filesystem::file_size(logPath) / (1024 * 1024);
-    if (logSize < MAX_LOG_SIZE_MB) return;
+    const GLogFormatInfo* format = slot.formatId ? GLogBinary::getFormat(slot.formatId) : nullptr;
+    GLogRecord record{slot.level, slot.truncated, slot.timestamp, slot.threadId, slot.source, {}, slot.formatId, std::string_view(slot.text, slot.length)};
+    if (slot.formatId) {
+        record.timestampNs = GLogClock::toNs(static_cast<uint64_t>(slot.timestamp));
+        if (format) record.source = GLogSourceLocation{format->file.c_str(), format->line};
+    }
+    dispatch(record, format);
+}
 
-    // Delete oldest file if limit exceeded
-    std::filesystem::path oldestFile = fmt::format("glog_{}.txt", MAX_LOG_FILES);
-    if (std::filesystem::exists(oldestFile)) {
-        std::filesystem::remove(oldestFile);
+void GLog::dispatch(GLogRecord& record, const GLogFormatInfo* format) {
+    // ✅ Nothing is formatted unless a text sink is going to take the record
+    bool needsText = false;
+    for (auto& sink : sinks) {
+        if (sink && sink->shouldLog(record.level) && !sink->acceptsBinary()) needsText = true;
     }
 
-    // Shift logs
-    for (int i = MAX_LOG_FILES - 1; i >= 1; --i) {
-        std::filesystem::path oldFile = fmt::format("glog_{}.txt", i);
-        std::filesystem::path newFile = fmt::format("glog_{}.txt", i + 1);
-        if (std::filesystem::exists(oldFile)) {
-            std::filesystem::rename(oldFile, newFile);
+    if (needsText) {
+        messageBuffer.clear();
+        if (record.formatId == 0) {
+            record.message = record.payload;
+        } else if (format) {
+            GLogBinary::formatMessage(format->format, format->argTypes, record.payload.data(), record.payload.size(), messageBuffer);
+        } else {
+            fmt::format_to(std::back_inserter(messageBuffer), "<unknown format {}>", record.formatId);
+        }
+        if (record.truncated) {
+            if (record.formatId == 0) messageBuffer.append(record.message);
+            messageBuffer.append(std::string_view("..."));
         }
+        if (record.formatId != 0 || record.truncated) record.message = std::string_view(messageBuffer.data(), messageBuffer.size());
     }
 
-    // Rename current log
-    std::filesystem::rename("glog.txt", "glog_1.txt");
+    static GMetricCounter& recordsWritten = GMetrics::counter("glog.records");
+    recordsWritten.add();
+
+    for (auto& sink : sinks) {
+        if (!sink || !sink->shouldLog(record.level)) continue;
+        sink->write(record);
+        if (record.level == GLogLevel::GLOG_ERROR) sink->flush(); // ✅ Errors reach the disk right away
+    }
 }
 
+void GLog::flushSinks() {
+    for (auto& sink : sinks) {
+        if (sink) sink->flush();
+    }
+}
 
-void GLog::close() {
-    std::cout << "[GLog] Closing logging system...\n";
+void GLog::workerLoop() {
+    std::cout << "[GLog] Worker thread started.\n";
 
-    if (ENABLE_ASYNC) {
+    while (true) {
+        size_t position;
+        GLogSlot* slot = ring->tryPop(position);
+        if (slot) {
+            writeSlot(*slot);
+            ring->release(slot, position);
+            consumedCount.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+
+        // ✅ close() flushes before stopping, so an empty ring here means we are done
+        if (stopWorker.load()) break;
+
+        // ✅ Idle: let sinks do time-based work such as flushing their buffers
         {
             std::lock_guard<std::mutex> lock(logMutex);
-            stopWorker = true;
+            for (auto& sink : sinks) {
+                if (sink) sink->poll();
+            }
+        }
+
+        // ✅ Nothing to do: announce that we sleep, then look once more before waiting
+        std::unique_lock<std::mutex> lock(workerMutex);
+        workerSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        slot = ring->tryPop(position);
+        if (slot) {
+            workerSleeping.store(false, std::memory_order_relaxed);
+            lock.unlock();
+            writeSlot(*slot);
+            ring->release(slot, position);
+            consumedCount.fetch_add(1, std::memory_order_release);
+            continue;
         }
+        // ✅ The timeout bounds the delay if a notify races with the wait
+        workerWake.wait_for(lock, std::chrono::milliseconds(50));
+        workerSleeping.store(false, std::memory_order_relaxed);
+    }
 
-        logCondition.notify_one();
+    std::cout << "[GLog] Worker thread exited cleanly.\n";
+}
 
-        if (workerThread.joinable()) {
-            std::cout << "[GLog] Waiting for worker thread to stop...\n";
-            workerThread.join();
-            std::cout << "[GLog] Worker thread successfully stopped.\n";
-        } else {
-            std::cerr << "[GLog] ERROR: Worker thread was not joinable!\n";
+void GLog::flush() {
+    if (ring && workerThread.joinable()) {
+        // ✅ Records claimed before this point are either written or dropped by drop-oldest
+        size_t target = ring->claimedCount();
+        while (consumedCount.load(std::memory_order_acquire) + droppedOldestCount.load(std::memory_order_acquire) < target) {
+            workerWake.notify_one();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    flushSinks();
+}
+
+void GLog::close() {
+    std::cout << "[GLog] Closing logging system...\n";
+
+    if (workerThread.joinable()) {
+        // ✅ Flush barrier: everything logged before close() reaches the sinks
+        flush();
+        stopWorker.store(true);
+        workerWake.notify_one();
+
+        std::cout << "[GLog] Waiting for worker thread to stop...\n";
+        workerThread.join();
+        std::cout << "[GLog] Worker thread successfully stopped.\n";
+
+        // ✅ Records published while the worker was stopping
+        size_t position;
+        while (GLogSlot* slot = ring->tryPop(position)) {
+            writeSlot(*slot);
+            ring->release(slot, position);
+            consumedCount.fetch_add(1);
+        }
+
+        if (droppedCount.load() > 0) {
+            std::cerr << "[GLog] WARNING: " << droppedCount.load() << " log records were dropped because the queue was full.\n";
         }
     }
 
@@ -210,3 +336,59 @@ void GLog::close() {
 
     std::cout << "[GLog] Logging system shutdown complete.\n";
 }
+
+BinaryFileSink::BinaryFileSink(const std::string& filename) {
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[GLog] ERROR: Failed to open binary log file: " << filename << std::endl;
+        return;
+    }
+    put(GLOG_BINARY_MAGIC);
+    put(GLOG_BINARY_VERSION);
+    put(uint16_t(0));
+}
+
+void BinaryFileSink::putString(std::string_view text) {
+    uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), UINT16_MAX));
+    put(length);
+    file.write(text.data(), length);
+}
+
+void BinaryFileSink::writeFormat(uint32_t formatId) {
+    if (formatId < writtenFormats.size() && writtenFormats[formatId]) return;
+
+    const GLogFormatInfo* format = GLogBinary::getFormat(formatId);
+    if (!format) return;
+
+    put(GLogBinaryEntry::Format);
+    put(formatId);
+    put(format->level);
+    put(format->line);
+    putString(format->file);
+    putString(format->format);
+    put(static_cast<uint8_t>(format->argTypes.size()));
+    file.write(reinterpret_cast<const char*>(format->argTypes.data()), static_cast<std::streamsize>(format->argTypes.size()));
+
+    if (writtenFormats.size() <= formatId) writtenFormats.resize(formatId + 1, false);
+    writtenFormats[formatId] = true;
+}
+
+void BinaryFileSink::write(const GLogRecord& record) {
+    if (!file.is_open()) return;
+    if (record.formatId != 0) writeFormat(record.formatId);
+
+    // ✅ Text records carry their message as the payload
+    uint16_t payloadSize = static_cast<uint16_t>(std::min<size_t>(record.payload.size(), UINT16_MAX));
+    put(GLogBinaryEntry::Record);
+    put(record.formatId);
+    put(record.level);
+    put(static_cast<uint8_t>(record.truncated || payloadSize < record.payload.size() ? 1 : 0));
+    put(record.timestampNs);
+    put(record.threadId);
+    put(payloadSize);
+    file.write(record.payload.data(), payloadSize);
+}
+
+void BinaryFileSink::flush() {
+    if (file.is_open()) file.flush();
+}
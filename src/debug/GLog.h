@@ -6,7 +6,6 @@
 #include <sstream>
 #include <chrono>
 #include <ctime>
-#include <queue>
 #include <thread>
 #include <condition_variable>
 #include <vector>
@@ -14,178 +13,176 @@
 #include <filesystem>
 #include <fmt/core.h>
 #include <atomic>
-#include <unordered_map>
+#include <fmt/format.h>
 #include "GLogUtils.h"
+#include "GLogRing.h"
+#include "GLogPattern.h"
+#include "GLogBinary.h"
+#include "GLogSink.h"
+#include "GLogFileSink.h"
+#include "GLogJsonSink.h"
+#include "GMetrics.h"
 
-class GLogSink {
+class ConsoleSink : public GLogSink {
 public:
-    virtual void write(const std::string& message) = 0;
-    virtual ~GLogSink() = default;
+    ConsoleSink() { setLevel(GLogLevel::GLOG_INFO); }
+
+    void write(const GLogRecord& record) override {
+        setConsoleColor(record.level);
+        std::cout << formatLine(record);
+        resetConsoleColor();
+    }
 };
 
-class ConsoleSink : public GLogSink {
-    public:
-        void write(const std::string& message) override {
-            setConsoleColor(detectLogLevel(message));
-            std::cout << message;
-            resetConsoleColor();
-        }
-    
-    private:
-        GLogLevel detectLogLevel(const std::string& message) {
-            if (message.find("[ERROR]") != std::string::npos) return GLogLevel::GLOG_ERROR;
-            if (message.find("[WARNING]") != std::string::npos) return GLogLevel::GLOG_WARN;
-            if (message.find("[INFO]") != std::string::npos) return GLogLevel::GLOG_INFO;
-            if (message.find("[DEBUG]") != std::string::npos) return GLogLevel::GLOG_DEBUG;
-            return GLogLevel::GLOG_INFO;
-        }
-    };
-
-    class FileSink : public GLogSink {
-        private:
-            std::ofstream file;
-        
-        public:
-            FileSink(const std::string& filename) {
-                file.open(filename, std::ios::out | std::ios::app);
-                if (!file.is_open()) {
-                    std::cerr << "[GLog] ERROR: Failed to open log file: " << filename << std::endl;
-                }
-            }
-        
-            bool isOpen() const { return file.is_open(); }
-        
-            void write(const std::string& message) override {
-                if (file.is_open()) {
-                    file << message;
-                    file.flush();
-                } else {
-                    std::cerr << "[GLog] ERROR: Log file is not open!" << std::endl;
-                }
-            }
-        };
+// ✅ Compact binary log for glog_decode: format strings are written once per file,
+// records only carry their arguments. Not flushed per record like FileSink.
+class BinaryFileSink : public GLogSink {
+public:
+    explicit BinaryFileSink(const std::string& filename);
+
+    bool isOpen() const { return file.is_open(); }
+    void write(const GLogRecord& record) override;
+    bool acceptsBinary() const override { return true; }
+    void flush() override;
+
+private:
+    template <typename T>
+    void put(const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void putString(std::string_view text);
+    void writeFormat(uint32_t formatId);
+
+    std::ofstream file;
+    std::vector<bool> writtenFormats; // By format id
+};
 
 class GLog {
 private:
     static std::mutex logMutex;
-    static std::queue<std::string> logQueue;
-    static std::condition_variable logCondition;
     static std::thread workerThread;
-    static bool stopWorker;
+    static std::atomic<bool> stopWorker;
     static std::atomic<bool> isInitialized;
     static std::vector<std::shared_ptr<GLogSink>> sinks;
-    static std::string logPattern;
+
+    // ✅ Async mode: producers write into the ring, the worker drains it into the sinks
+    static std::unique_ptr<GLogRing> ring;
+    static std::mutex workerMutex;               // Only used by the worker to sleep
+    static std::condition_variable workerWake;
+    static std::atomic<bool> workerSleeping;
+    static std::atomic<size_t> consumedCount;     // Records written to the sinks
+    static std::atomic<size_t> droppedOldestCount; // Records popped by producers under GLOG_DROP_OLDEST
+    static std::atomic<size_t> droppedCount;      // All records lost to overflow
+    static std::atomic<GLogOverflowPolicy> overflowPolicy;
+
     static void workerLoop();
-    static void rotateLogFile();
-    static bool shouldLog(GLogLevel level);
-    static std::string getTimestamp();
-    static std::string logLevelToString(GLogLevel level);
-    static std::string getThreadID();
-    static std::string getLogLevelColor(GLogLevel level);
+    static void writeSlot(const GLogSlot& slot);
+    static void writeMessage(GLogLevel level, GLogSourceLocation source, std::string_view message, int64_t timestampNs, uint64_t threadId);
+    static void dispatch(GLogRecord& record, const GLogFormatInfo* format); // Caller holds logMutex
+    static void flushSinks();                                               // Caller holds logMutex
+    static fmt::memory_buffer messageBuffer; // Messages built for text sinks, guarded by logMutex
+    static GLogSlot* claimSlot(size_t& outPosition);
+    static void wakeWorker();
+    static uint64_t currentThreadId();
+    static int64_t nowNs();
 
 public:
     static void init(const std::string& filename = "glog.txt");
     static void addSink(std::shared_ptr<GLogSink> sink);
     static void setLogLevel(GLogLevel level);
+
+    // ✅ Runtime level check, inlined so the GLOG_* macros can skip formatting the arguments
+    static bool shouldLog(GLogLevel level) {
+        return static_cast<int>(level) >= static_cast<int>(CURRENT_LOG_LEVEL.load(std::memory_order_relaxed));
+    }
     static void close();
-    static void setPattern(const std::string& pattern);
+    static void setPattern(const std::string& pattern); // ✅ Applies to every sink added so far
+
+    // ✅ Blocks until every record logged before the call has reached the sinks
+    static void flush();
+    static void setOverflowPolicy(GLogOverflowPolicy policy);
+    static size_t getQueueDepth(); // ✅ Records waiting for the async worker
+    static size_t getDroppedCount();
 
     template <typename... Args>
     static void log(GLogLevel level, fmt::format_string<Args...> fmtStr, Args&&... args) {
-        if (!isInitialized.load()) {
+        log(GLogSourceLocation{}, level, fmtStr, std::forward<Args>(args)...);
+    }
+
+    // ✅ The GLOG_* macros pass their call site
+    template <typename... Args>
+    static void log(GLogSourceLocation source, GLogLevel level, fmt::format_string<Args...> fmtStr, Args&&... args) {
+        if (!isInitialized.load(std::memory_order_relaxed)) {
             std::cerr << "[GLog] WARNING: Attempted to log after GLog::close()!" << std::endl;
             return;
         }
         if (!shouldLog(level)) return;
 
-        std::string message = fmt::format(fmtStr, std::forward<Args>(args)...);
-        std::string formattedMessage = formatLogEntry(level, message);
-
-        std::lock_guard<std::mutex> lock(logMutex);
-        for (auto& sink : sinks) {
-            if (sink) {
-                sink->write(formattedMessage + "\n");
-            }
+        if (!ring) {
+            // ✅ Synchronous mode: format and write on the calling thread, into a buffer kept per thread
+            thread_local fmt::memory_buffer message;
+            message.clear();
+            fmt::format_to(std::back_inserter(message), fmtStr, std::forward<Args>(args)...);
+            writeMessage(level, source, std::string_view(message.data(), message.size()), nowNs(), currentThreadId());
+            return;
         }
-    }
 
-private:
-    static std::string formatLogEntry(GLogLevel level, const std::string& message) {
-        std::lock_guard<std::mutex> lock(logMutex);
-
-        std::unordered_map<std::string, std::string> replacements = {
-            {"%Y", getTimestamp().substr(1, 4)},
-            {"%m", getTimestamp().substr(6, 2)},
-            {"%d", getTimestamp().substr(9, 2)},
-            {"%H", getTimestamp().substr(12, 2)},
-            {"%M", getTimestamp().substr(15, 2)},
-            {"%S", getTimestamp().substr(18, 2)},
-            {"%e", "000"},  // No millisecond support yet
-            {"%l", logLevelToString(level)},
-            {"%v", message},
-            {"%t", getThreadID()},
-            {"%n", "GLog"}  // Logger name (not used in GLog)
-        };
+        // ✅ Async mode: format straight into a ring slot, no allocation, no lock, no I/O
+        size_t position;
+        GLogSlot* slot = claimSlot(position);
+        if (!slot) return; // Dropped by the overflow policy
+
+        slot->timestamp = nowNs();
+        slot->formatId = 0;
+        slot->source = source;
+        slot->threadId = currentThreadId();
+        slot->level = level;
+        auto result = fmt::format_to_n(slot->text, sizeof(slot->text), fmtStr, std::forward<Args>(args)...);
+        slot->truncated = result.size > sizeof(slot->text);
+        slot->length = static_cast<uint16_t>(slot->truncated ? sizeof(slot->text) : result.size);
+        ring->publish(slot, position);
+        wakeWorker();
+    }
 
-        std::string formattedPattern = logPattern;
-        
-        // Handle color formatting (%^ and %$)
-        std::string colorCode = getLogLevelColor(level);
-        size_t pos = formattedPattern.find("%^");
-        if (pos != std::string::npos) {
-            formattedPattern.replace(pos, 2, colorCode);
+    // ✅ Deferred formatting (GLOG_*_BIN): the call site registers its format string once,
+    // after that only the raw arguments and a TSC timestamp are copied into the ring
+    template <typename... Args>
+    static void logBinary(std::atomic<uint32_t>& callsiteFormatId, GLogLevel level, const char* file, uint32_t line,
+                          fmt::format_string<Args...> fmtStr, Args&&... args) {
+        if (!isInitialized.load(std::memory_order_relaxed)) {
+            std::cerr << "[GLog] WARNING: Attempted to log after GLog::close()!" << std::endl;
+            return;
         }
-        pos = formattedPattern.find("%$");
-        if (pos != std::string::npos) {
-            formattedPattern.replace(pos, 2, "\033[0m");  // Reset color
+        if (!shouldLog(level)) return;
+
+        uint32_t formatId = callsiteFormatId.load(std::memory_order_acquire);
+        if (formatId == 0) {
+            // Two threads racing here register the call site twice, which is harmless
+            fmt::string_view format = fmtStr;
+            formatId = GLogBinary::registerFormat(level, file, line, std::string_view(format.data(), format.size()),
+                                                  {GLogBinary::argType<Args>()...});
+            callsiteFormatId.store(formatId, std::memory_order_release);
         }
 
-        // Replace all other placeholders
-        for (const auto& [key, value] : replacements) {
-            size_t pos = 0;
-            while ((pos = formattedPattern.find(key, pos)) != std::string::npos) {
-                formattedPattern.replace(pos, key.length(), value);
-                pos += value.length();
-            }
+        auto fill = [&](GLogSlot& slot) {
+            slot.timestamp = static_cast<int64_t>(GLogClock::ticks());
+            slot.threadId = currentThreadId();
+            slot.level = level;
+            slot.formatId = formatId;
+            slot.length = GLogBinary::encode(slot.text, sizeof(slot.text), slot.truncated, args...);
+        };
+
+        if (!ring) {
+            // ✅ Synchronous mode: same record, built on the stack and written right away
+            GLogSlot localSlot;
+            fill(localSlot);
+            writeSlot(localSlot);
+            return;
         }
 
-        return formattedPattern;
+        size_t position;
+        GLogSlot* slot = claimSlot(position);
+        if (!slot) return; // Dropped by the overflow policy
+        fill(*slot);
+        ring->publish(slot, position);
+        wakeWorker();
     }
 };
-
-// ✅ Default pattern: Same as `spdlog`
-inline std::string GLog::logPattern = "[%Y-%m-%d %H:%M:%S] [%l] %v";
-
-// ✅ Thread-safe pattern setting
-inline void GLog::setPattern(const std::string& pattern) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    logPattern = pattern;
-}
-
-// ✅ Gets thread ID
-inline std::string GLog::getThreadID() {
-    std::ostringstream ss;
-    ss << std::this_thread::get_id();
-    return ss.str();
-}
-
-// ✅ Gets color codes for log levels
-inline std::string GLog::getLogLevelColor(GLogLevel level) {
-#ifdef _WIN32
-    switch (level) {
-        case GLogLevel::GLOG_INFO: return "\033[1;33m";   // Yellow
-        case GLogLevel::GLOG_WARN: return "\033[1;35m";   // Magenta
-        case GLogLevel::GLOG_ERROR: return "\033[1;31m";  // Red
-        case GLogLevel::GLOG_DEBUG: return "\033[1;32m";  // Green
-        default: return "";
-    }
-#else
-    switch (level) {
-        case GLogLevel::GLOG_INFO: return "\033[1;33m";   // Yellow
-        case GLogLevel::GLOG_WARN: return "\033[1;35m";   // Magenta
-        case GLogLevel::GLOG_ERROR: return "\033[1;31m";  // Red
-        case GLogLevel::GLOG_DEBUG: return "\033[1;32m";  // Green
-        default: return "";
-    }
-#endif
-}
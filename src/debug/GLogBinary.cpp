@@ -0,0 +1,101 @@
+#include "GLogBinary.h"
+#include <fmt/args.h>
+#include <thread>
+
+std::mutex GLogBinary::registryMutex;
+std::deque<GLogFormatInfo> GLogBinary::formats;
+
+bool GLogClock::calibrated = false;
+uint64_t GLogClock::baseTicks = 0;
+int64_t GLogClock::baseNs = 0;
+uint64_t GLogClock::syncTicks = 0;
+int64_t GLogClock::syncNs = 0;
+double GLogClock::ticksPerNs = 1.0;
+uint32_t GLogClock::conversionsSinceSync = 0;
+
+uint32_t GLogBinary::registerFormat(GLogLevel level, const char* file, uint32_t line, std::string_view format, std::initializer_list<GLogArgType> argTypes) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    formats.push_back(GLogFormatInfo{level, file, line, std::string(format), std::vector<GLogArgType>(argTypes)});
+    return static_cast<uint32_t>(formats.size());
+}
+
+const GLogFormatInfo* GLogBinary::getFormat(uint32_t formatId) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (formatId == 0 || formatId > formats.size()) return nullptr;
+    return &formats[formatId - 1];
+}
+
+void GLogBinary::formatMessage(std::string_view format, const std::vector<GLogArgType>& argTypes, const char* payload, size_t payloadSize, fmt::memory_buffer& out) {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    const char* cursor = payload;
+    const char* end = payload + payloadSize;
+
+    auto take = [&](auto& raw) {
+        if (static_cast<size_t>(end - cursor) < sizeof(raw)) return false;
+        std::memcpy(&raw, cursor, sizeof(raw));
+        cursor += sizeof(raw);
+        return true;
+    };
+
+    for (GLogArgType type : argTypes) {
+        bool ok = false;
+        switch (type) {
+            case GLogArgType::Int32: { int32_t v; if ((ok = take(v))) store.push_back(v); break; }
+            case GLogArgType::UInt32: { uint32_t v; if ((ok = take(v))) store.push_back(v); break; }
+            case GLogArgType::Int64: { int64_t v; if ((ok = take(v))) store.push_back(v); break; }
+            case GLogArgType::UInt64: { uint64_t v; if ((ok = take(v))) store.push_back(v); break; }
+            case GLogArgType::Double: { double v; if ((ok = take(v))) store.push_back(v); break; }
+            case GLogArgType::Bool: { uint8_t v; if ((ok = take(v))) store.push_back(v != 0); break; }
+            case GLogArgType::Char: { char v; if ((ok = take(v))) store.push_back(v); break; }
+            case GLogArgType::Pointer: {
+                uint64_t v;
+                if ((ok = take(v))) store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(v)));
+                break;
+            }
+            case GLogArgType::String: {
+                uint16_t length;
+                if ((ok = take(length) && static_cast<size_t>(end - cursor) >= length)) {
+                    store.push_back(fmt::string_view(cursor, length)); // Not copied, the payload outlives the call
+                    cursor += length;
+                }
+                break;
+            }
+        }
+        if (!ok) store.push_back(fmt::string_view("<?>"));
+    }
+
+    try {
+        fmt::vformat_to(std::back_inserter(out), fmt::string_view(format.data(), format.size()), store);
+    } catch (const fmt::format_error& e) {
+        fmt::format_to(std::back_inserter(out), "{} <format error: {}>", format, e.what());
+    }
+}
+
+void GLogClock::calibrate() {
+    syncTicks = ticks();
+    syncNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    conversionsSinceSync = 0;
+
+    if (!calibrated) {
+        // ✅ The first rate estimate needs a measurable interval; this costs the worker 1 ms once
+        baseTicks = syncTicks;
+        baseNs = syncNs;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        calibrated = true;
+        calibrate();
+        return;
+    }
+
+    // ✅ The longer the baseline, the more precise the rate
+    if (syncNs > baseNs && syncTicks > baseTicks) {
+        ticksPerNs = static_cast<double>(syncTicks - baseTicks) / static_cast<double>(syncNs - baseNs);
+    }
+}
+
+int64_t GLogClock::toNs(uint64_t recordTicks) {
+    // ✅ Re-sync now and then so the error stays small over a long session
+    if (!calibrated || (++conversionsSinceSync >= 1024 && recordTicks > syncTicks)) calibrate();
+
+    double deltaTicks = recordTicks >= syncTicks ? static_cast<double>(recordTicks - syncTicks) : -static_cast<double>(syncTicks - recordTicks);
+    return syncNs + static_cast<int64_t>(deltaTicks / ticksPerNs);
+}
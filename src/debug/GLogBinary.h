@@ -0,0 +1,179 @@
+#pragma once
+#include "GLogConfig.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define GLOG_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define GLOG_HAS_TSC 1
+#endif
+
+/*
+    ✅ Binary (deferred formatting) logging, see GLOG_*_BIN in GLogMacros.h
+
+    Each call site registers its format string once and gets a format id. The
+    producer then only copies the raw argument bytes and a TSC timestamp into
+    the ring. The worker formats them for text sinks, while BinaryFileSink
+    stores them as they are and glog_decode turns the file back into text.
+
+    .glb layout (host byte order):
+        header: uint32 magic, uint16 version, uint16 reserved
+        then entries, each starting with a uint8 GLogBinaryEntry:
+        Format: uint32 id, uint8 level, uint32 line, uint16 fileLength, file,
+                uint16 formatLength, format, uint8 argCount, uint8 argTypes[argCount]
+        Record: uint32 formatId, uint8 level, uint8 truncated, int64 timestampNs,
+                uint64 threadId, uint16 payloadSize, payload
+    Format 0 is implicit: its payload is an already formatted message.
+*/
+
+constexpr uint32_t GLOG_BINARY_MAGIC = 0x42474C47; // "GLGB"
+constexpr uint16_t GLOG_BINARY_VERSION = 1;
+
+enum class GLogBinaryEntry : uint8_t {
+    Format = 1,
+    Record = 2
+};
+
+// ✅ How one argument is stored in the payload
+enum class GLogArgType : uint8_t {
+    Int32,   // 4 bytes, also for smaller signed integers
+    UInt32,  // 4 bytes, also for smaller unsigned integers
+    Int64,
+    UInt64,
+    Double,  // 8 bytes, float is widened
+    Bool,    // 1 byte
+    Char,    // 1 byte
+    String,  // uint16 length + bytes, cut to what fits in the slot
+    Pointer  // 8 bytes
+};
+
+struct GLogFormatInfo {
+    GLogLevel level;
+    std::string file;
+    uint32_t line;
+    std::string format;
+    std::vector<GLogArgType> argTypes;
+};
+
+class GLogBinary {
+public:
+    // ✅ Thread-safe. Ids start at 1 and are never reused.
+    static uint32_t registerFormat(GLogLevel level, const char* file, uint32_t line, std::string_view format, std::initializer_list<GLogArgType> argTypes);
+    static const GLogFormatInfo* getFormat(uint32_t formatId); // nullptr if unknown; entries never move
+
+    template <typename T>
+    static constexpr GLogArgType argType();
+
+    // ✅ Writes the arguments into out and returns the payload size. Arguments that
+    // do not fit are left out (strings are cut first) and truncated is set.
+    template <typename... Args>
+    static uint16_t encode(char* out, size_t capacity, bool& truncated, const Args&... args);
+
+    // ✅ Formats a payload, used by the worker for text sinks and by glog_decode.
+    // Missing (truncated) arguments print as "<?>".
+    static void formatMessage(std::string_view format, const std::vector<GLogArgType>& argTypes, const char* payload, size_t payloadSize, fmt::memory_buffer& out);
+
+private:
+    template <typename T>
+    static bool encodeArg(char*& out, char* end, const T& value);
+
+    static std::mutex registryMutex;
+    static std::deque<GLogFormatInfo> formats;
+};
+
+// ✅ Cheap timestamps for binary records: the TSC where there is one, steady_clock
+// elsewhere. Ticks are turned into wall-clock time on the worker thread.
+class GLogClock {
+public:
+    static uint64_t ticks() {
+#ifdef GLOG_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // ✅ Not thread-safe: GLog only calls it under its log mutex
+    static int64_t toNs(uint64_t ticks);
+
+private:
+    static void calibrate();
+
+    static bool calibrated;
+    static uint64_t baseTicks;
+    static int64_t baseNs;
+    static uint64_t syncTicks;  // Latest (ticks, time) pair, conversions start from here
+    static int64_t syncNs;
+    static double ticksPerNs;   // Measured from the base pair to the latest pair
+    static uint32_t conversionsSinceSync;
+};
+
+template <typename T>
+constexpr GLogArgType GLogBinary::argType() {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) return GLogArgType::Bool;
+    else if constexpr (std::is_same_v<U, char>) return GLogArgType::Char;
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) return sizeof(U) <= 4 ? GLogArgType::Int32 : GLogArgType::Int64;
+    else if constexpr (std::is_integral_v<U>) return sizeof(U) <= 4 ? GLogArgType::UInt32 : GLogArgType::UInt64;
+    else if constexpr (std::is_floating_point_v<U>) return GLogArgType::Double;
+    else if constexpr (std::is_convertible_v<const U&, std::string_view>) return GLogArgType::String;
+    else if constexpr (std::is_pointer_v<U>) return GLogArgType::Pointer;
+    else {
+        static_assert(sizeof(U) == 0, "GLOG_*_BIN only takes numbers, strings and pointers");
+        return GLogArgType::Int32;
+    }
+}
+
+template <typename T>
+bool GLogBinary::encodeArg(char*& out, char* end, const T& value) {
+    constexpr GLogArgType type = argType<T>();
+    auto put = [&](const auto& raw) {
+        if (static_cast<size_t>(end - out) < sizeof(raw)) return false;
+        std::memcpy(out, &raw, sizeof(raw));
+        out += sizeof(raw);
+        return true;
+    };
+
+    if constexpr (type == GLogArgType::Int32) return put(static_cast<int32_t>(value));
+    else if constexpr (type == GLogArgType::UInt32) return put(static_cast<uint32_t>(value));
+    else if constexpr (type == GLogArgType::Int64) return put(static_cast<int64_t>(value));
+    else if constexpr (type == GLogArgType::UInt64) return put(static_cast<uint64_t>(value));
+    else if constexpr (type == GLogArgType::Double) return put(static_cast<double>(value));
+    else if constexpr (type == GLogArgType::Bool) return put(static_cast<uint8_t>(value ? 1 : 0));
+    else if constexpr (type == GLogArgType::Char) return put(value);
+    else if constexpr (type == GLogArgType::Pointer) return put(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+    else {
+        std::string_view text(value);
+        if (end - out < 2) return false;
+        size_t room = static_cast<size_t>(end - out) - 2;
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>({text.size(), room, UINT16_MAX}));
+        put(length);
+        std::memcpy(out, text.data(), length);
+        out += length;
+        return length == text.size();
+    }
+}
+
+template <typename... Args>
+uint16_t GLogBinary::encode(char* out, size_t capacity, bool& truncated, const Args&... args) {
+    char* cursor = out;
+    char* end = out + capacity;
+    bool complete = true;
+    // Stops at the first argument that does not fit completely
+    ((complete = complete && encodeArg(cursor, end, args)), ...);
+    truncated = !complete;
+    return static_cast<uint16_t>(cursor - out);
+}
@@ -3,19 +3,62 @@
 #ifndef GLOG_CONFIG_H
 #define GLOG_CONFIG_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ✅ Numeric levels for the preprocessor, ordered by severity
+#define GLOG_LEVEL_DEBUG 0
+#define GLOG_LEVEL_INFO 1
+#define GLOG_LEVEL_WARN 2
+#define GLOG_LEVEL_ERROR 3
+#define GLOG_LEVEL_OFF 4
+
+// ✅ Lowest level compiled in: GLOG_* macros below it expand to nothing, arguments included.
+// Override with -DGLOG_ACTIVE_LEVEL=GLOG_LEVEL_WARN etc.
+#ifndef GLOG_ACTIVE_LEVEL
+    #ifdef NDEBUG
+        #define GLOG_ACTIVE_LEVEL GLOG_LEVEL_INFO
+    #else
+        #define GLOG_ACTIVE_LEVEL GLOG_LEVEL_DEBUG
+    #endif
+#endif
+
 // ✅ Ensure GLogLevel is defined before use
-enum class GLogLevel {
-    GLOG_INFO,
-    GLOG_WARN,
-    GLOG_ERROR,
-    GLOG_DEBUG
+enum class GLogLevel : uint8_t {
+    GLOG_DEBUG = GLOG_LEVEL_DEBUG,
+    GLOG_INFO = GLOG_LEVEL_INFO,
+    GLOG_WARN = GLOG_LEVEL_WARN,
+    GLOG_ERROR = GLOG_LEVEL_ERROR
+};
+
+// ✅ What an async log call does when the ring buffer is full
+enum class GLogOverflowPolicy {
+    GLOG_BLOCK,       // Wait for the worker to free a slot (spins, never locks)
+    GLOG_DROP_NEWEST, // Discard the record being logged
+    GLOG_DROP_OLDEST  // Discard the oldest queued record to make room
 };
 
 // ✅ Default Log Settings (Kept from before)
-inline GLogLevel CURRENT_LOG_LEVEL = GLogLevel::GLOG_INFO;
-static bool ENABLE_ASYNC = true;
-static bool ENABLE_LOG_ROTATION = true;
-static size_t MAX_LOG_SIZE_MB = 10; // ✅ Rotate at 10MB
-static int MAX_LOG_FILES = 5; // ✅ Keep last 5 logs
+inline std::atomic<GLogLevel> CURRENT_LOG_LEVEL{GLogLevel::GLOG_INFO}; // ✅ Runtime minimum, see GLog::setLogLevel
+inline bool ENABLE_ASYNC = true;
+inline bool ENABLE_LOG_ROTATION = true;
+inline size_t MAX_LOG_SIZE_MB = 10; // ✅ Rotate at 10MB
+inline int MAX_LOG_FILES = 5; // ✅ Keep last 5 logs
+
+// ✅ FileSink buffering: written out when full, after the interval, or right after an ERROR
+inline size_t LOG_FILE_BUFFER_SIZE = 256 * 1024;
+inline int LOG_FLUSH_INTERVAL_MS = 1000;
+inline bool ENABLE_LOG_COMPRESSION = true; // ✅ gzip rotated logs in the background (needs zlib)
+
+// ✅ Async ring buffer: preallocated slots, messages longer than a slot are truncated
+constexpr size_t GLOG_SLOT_SIZE = 512;
+inline size_t LOG_QUEUE_CAPACITY = 4096; // ✅ Slots, rounded up to a power of two (2MB)
+inline GLogOverflowPolicy LOG_OVERFLOW_POLICY = GLogOverflowPolicy::GLOG_BLOCK;
+
+// ✅ Also write every record to <log name>.glb for glog_decode (see GLogBinary.h)
+inline bool ENABLE_BINARY_LOG = false;
+// ✅ Also write every record to <log name>.jsonl, one JSON object per line
+inline bool ENABLE_JSON_LOG = false;
 
 #endif // GLOG_CONFIG_H
@@ -0,0 +1,229 @@
+#include "GLogFileSink.h"
+#include <fmt/format.h>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+#ifdef GLOG_HAS_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char* ROTATING_MARKER = "_rotating_";
+
+// ✅ "logs_rotating_<ms>_<n>.txt" waits for the archiver
+static fs::path RotatingFilePath(const fs::path& logPath, int64_t stamp, uint32_t index) {
+    return logPath.parent_path() / fmt::format("{}{}{}_{}{}", logPath.stem().string(), ROTATING_MARKER, stamp, index, logPath.extension().string());
+}
+
+// ✅ Inverse of RotatingFilePath. The extension has to match too: logs.txt and logs.jsonl
+// share the stem, and each sink must only pick up its own leftovers.
+static bool IsRotatingFile(const fs::path& logPath, const fs::path& candidate) {
+    std::string prefix = logPath.stem().string() + ROTATING_MARKER;
+    std::string extension = logPath.extension().string();
+    std::string name = candidate.filename().string();
+    if (candidate.extension() != logPath.extension() || name.size() <= prefix.size() + extension.size() || name.rfind(prefix, 0) != 0) return false;
+
+    // <ms>_<n> between the prefix and the extension
+    std::string_view middle(name.data() + prefix.size(), name.size() - prefix.size() - extension.size());
+    size_t separator = middle.find('_');
+    if (separator == std::string_view::npos || separator == 0 || separator + 1 == middle.size()) return false;
+    for (size_t i = 0; i < middle.size(); ++i) {
+        if (i != separator && (middle[i] < '0' || middle[i] > '9')) return false;
+    }
+    return true;
+}
+
+GLogArchiver::GLogArchiver(fs::path logPath, int maxFiles) : logPath(std::move(logPath)), maxFiles(maxFiles) {
+    worker = std::thread(&GLogArchiver::workerLoop, this);
+}
+
+GLogArchiver::~GLogArchiver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void GLogArchiver::enqueue(fs::path rotatedFile) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(rotatedFile));
+    }
+    wake.notify_one();
+}
+
+void GLogArchiver::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) break; // Stopping with nothing left
+
+        fs::path job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        archive(job);
+        lock.lock();
+    }
+}
+
+fs::path GLogArchiver::archivePath(int index, bool compressed) const {
+    // logs.txt -> logs_3.txt(.gz)
+    fs::path name = fmt::format("{}_{}{}{}", logPath.stem().string(), index, logPath.extension().string(), compressed ? ".gz" : "");
+    return logPath.parent_path() / name;
+}
+
+// ✅ gzip through a temporary file so a crash never leaves a half-written archive
+static bool CompressFile(const fs::path& source, const fs::path& target) {
+#ifdef GLOG_HAS_ZLIB
+    std::ifstream in(source, std::ios::binary);
+    fs::path tempPath = target.string() + ".tmp";
+    gzFile out = gzopen(tempPath.string().c_str(), "wb6");
+    if (!in || !out) {
+        if (out) gzclose(out);
+        return false;
+    }
+
+    std::vector<char> chunk(256 * 1024);
+    bool ok = true;
+    while (ok && in) {
+        in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        std::streamsize count = in.gcount();
+        if (count > 0) ok = gzwrite(out, chunk.data(), static_cast<unsigned>(count)) == count;
+    }
+    ok = gzclose(out) == Z_OK && ok;
+
+    std::error_code error;
+    if (ok) fs::rename(tempPath, target, error);
+    if (!ok || error) {
+        fs::remove(tempPath, error);
+        return false;
+    }
+    return true;
+#else
+    (void)source;
+    (void)target;
+    return false;
+#endif
+}
+
+void GLogArchiver::archive(const fs::path& rotatedFile) {
+    std::error_code error;
+
+    // ✅ Drop the oldest, then shift name_i to name_(i+1)
+    fs::remove(archivePath(maxFiles, true), error);
+    fs::remove(archivePath(maxFiles, false), error);
+    for (int i = maxFiles - 1; i >= 1; --i) {
+        for (bool compressed : {true, false}) {
+            if (fs::exists(archivePath(i, compressed), error)) {
+                fs::rename(archivePath(i, compressed), archivePath(i + 1, compressed), error);
+            }
+        }
+    }
+
+    if (ENABLE_LOG_COMPRESSION && CompressFile(rotatedFile, archivePath(1, true))) {
+        fs::remove(rotatedFile, error);
+    } else {
+        fs::rename(rotatedFile, archivePath(1, false), error);
+    }
+    if (error) {
+        std::cerr << "[GLog] ERROR: Failed to archive " << rotatedFile << ": " << error.message() << std::endl;
+    }
+}
+
+FileSink::FileSink(const std::string& filename, size_t maxBytes, int maxFiles)
+    : path(filename), maxBytes(maxBytes), nextRotationBytes(maxBytes), maxFiles(maxFiles), lastFlush(std::chrono::steady_clock::now()) {
+    file.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[GLog] ERROR: Failed to open log file: " << filename << std::endl;
+        return;
+    }
+
+    // ✅ The only size query: from here on the sink counts what it writes
+    std::error_code error;
+    uintmax_t existingBytes = fs::file_size(path, error);
+    fileBytes = error ? 0 : static_cast<size_t>(existingBytes);
+    buffer.reserve(LOG_FILE_BUFFER_SIZE);
+
+    // ✅ Files rotated right before a crash never reached the archive
+    fs::path directory = path.parent_path().empty() ? fs::path(".") : path.parent_path();
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        if (IsRotatingFile(path, entry.path())) {
+            if (!archiver) archiver = std::make_unique<GLogArchiver>(path, maxFiles);
+            archiver->enqueue(entry.path());
+        }
+    }
+}
+
+FileSink::~FileSink() {
+    flush();
+    file.close();
+    archiver.reset(); // Waits for pending compression
+}
+
+void FileSink::write(const GLogRecord& record) {
+    append(formatLine(record));
+}
+
+void FileSink::append(std::string_view text) {
+    if (!file.is_open()) {
+        std::cerr << "[GLog] ERROR: Log file is not open!" << std::endl;
+        return;
+    }
+
+    buffer += text;
+    fileBytes += text.size();
+
+    if (buffer.size() >= LOG_FILE_BUFFER_SIZE ||
+        std::chrono::steady_clock::now() - lastFlush >= std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS)) {
+        flush();
+    }
+    if (ENABLE_LOG_ROTATION && fileBytes >= nextRotationBytes) rotate();
+}
+
+void FileSink::flush() {
+    lastFlush = std::chrono::steady_clock::now();
+    if (buffer.empty() || !file.is_open()) return;
+
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.flush();
+    buffer.clear();
+}
+
+void FileSink::poll() {
+    if (!buffer.empty() && std::chrono::steady_clock::now() - lastFlush >= std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS)) {
+        flush();
+    }
+}
+
+void FileSink::rotate() {
+    flush();
+    file.close();
+
+    // ✅ Only a rename happens here, the archiver shifts and compresses in the background
+    int64_t stamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    fs::path rotatedFile = RotatingFilePath(path, stamp, rotationCount++);
+
+    std::error_code error;
+    fs::rename(path, rotatedFile, error);
+    if (error) {
+        std::cerr << "[GLog] ERROR: Failed to rotate " << path << ": " << error.message() << std::endl;
+    } else {
+        if (!archiver) archiver = std::make_unique<GLogArchiver>(path, maxFiles);
+        archiver->enqueue(rotatedFile);
+    }
+
+    file.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    fileBytes = 0;
+    nextRotationBytes = maxBytes;
+    if (error) {
+        // Keep appending to the old file rather than rotating on every line; try again after another maxBytes
+        std::error_code sizeError;
+        uintmax_t existingBytes = fs::file_size(path, sizeError);
+        fileBytes = sizeError ? 0 : static_cast<size_t>(existingBytes);
+        nextRotationBytes = fileBytes + maxBytes;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "GLogConfig.h"
+#include "GLogSink.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// ✅ Moves rotated logs into the archive on its own thread: shifts name_1..name_N,
+// then gzips the new file into name_1 (plain copy without zlib). Jobs run in order.
+class GLogArchiver {
+public:
+    GLogArchiver(std::filesystem::path logPath, int maxFiles);
+    ~GLogArchiver(); // Finishes the queued jobs
+
+    void enqueue(std::filesystem::path rotatedFile);
+
+private:
+    void workerLoop();
+    void archive(const std::filesystem::path& rotatedFile);
+    std::filesystem::path archivePath(int index, bool compressed) const;
+
+    std::filesystem::path logPath;
+    int maxFiles;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::filesystem::path> jobs;
+    bool stopping = false;
+    std::thread worker;
+};
+
+// ✅ Buffered, rotating log file. Counts its bytes instead of asking the filesystem,
+// writes the buffer out when it is full or LOG_FLUSH_INTERVAL_MS old (GLog flushes
+// right after ERROR records) and rotates at maxBytes. Called under GLog's log mutex.
+class FileSink : public GLogSink {
+public:
+    explicit FileSink(const std::string& filename, size_t maxBytes = MAX_LOG_SIZE_MB * 1024 * 1024, int maxFiles = MAX_LOG_FILES);
+    ~FileSink() override;
+
+    bool isOpen() const { return file.is_open(); }
+    void write(const GLogRecord& record) override;
+    void flush() override;
+    void poll() override;
+
+protected:
+    void append(std::string_view text); // Buffers one finished line, flushing and rotating as needed
+
+private:
+    void rotate();
+
+    std::filesystem::path path;
+    std::ofstream file;
+    std::string buffer;
+    size_t fileBytes = 0; // On disk plus buffered
+    size_t maxBytes;
+    size_t nextRotationBytes; // maxBytes, or further out while a failed rename is retried later
+    int maxFiles;
+    uint32_t rotationCount = 0;
+    std::chrono::steady_clock::time_point lastFlush;
+    std::unique_ptr<GLogArchiver> archiver;
+};
@@ -0,0 +1,73 @@
+#include "GLogJsonSink.h"
+#include <climits>
+#include <ctime>
+
+static std::string_view levelName(GLogLevel level) {
+    switch (level) {
+        case GLogLevel::GLOG_DEBUG: return "DEBUG";
+        case GLogLevel::GLOG_INFO: return "INFO";
+        case GLogLevel::GLOG_WARN: return "WARN";
+        case GLogLevel::GLOG_ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+// ✅ Escapes quotes, backslashes and control characters; UTF-8 passes through
+static void appendJsonString(fmt::memory_buffer& out, std::string_view text) {
+    out.push_back('"');
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(text.data() + runStart, text.data() + i);
+        switch (c) {
+            case '"': out.append(std::string_view("\\\"")); break;
+            case '\\': out.append(std::string_view("\\\\")); break;
+            case '\n': out.append(std::string_view("\\n")); break;
+            case '\r': out.append(std::string_view("\\r")); break;
+            case '\t': out.append(std::string_view("\\t")); break;
+            default: fmt::format_to(std::back_inserter(out), "\\u{:04x}", c); break;
+        }
+        runStart = i + 1;
+    }
+    out.append(text.data() + runStart, text.data() + text.size());
+    out.push_back('"');
+}
+
+void JsonLinesSink::write(const GLogRecord& record) {
+    int64_t seconds = record.timestampNs / 1000000000;
+    int64_t remainderNs = record.timestampNs % 1000000000;
+    if (remainderNs < 0) {
+        seconds -= 1;
+        remainderNs += 1000000000;
+    }
+
+    // ✅ UTC, rendered once per second
+    if (seconds != cachedSecond) {
+        std::time_t time = static_cast<std::time_t>(seconds);
+        std::tm utcTime;
+#ifdef _WIN32
+        gmtime_s(&utcTime, &time);
+#else
+        gmtime_r(&time, &utcTime);
+#endif
+        std::strftime(cachedTime, sizeof(cachedTime), "%Y-%m-%dT%H:%M:%S", &utcTime);
+        cachedSecond = seconds;
+    }
+
+    lineBuffer.clear();
+    fmt::format_to(std::back_inserter(lineBuffer), "{{\"ts\":{},\"time\":\"{}.{:03}Z\",\"level\":\"{}\",\"thread\":{}",
+                   record.timestampNs, cachedTime, remainderNs / 1000000, levelName(record.level), record.threadId);
+    if (record.source.file) {
+        lineBuffer.append(std::string_view(",\"file\":"));
+        appendJsonString(lineBuffer, record.source.file);
+        fmt::format_to(std::back_inserter(lineBuffer), ",\"line\":{}", record.source.line);
+    }
+    lineBuffer.append(std::string_view(",\"msg\":"));
+    appendJsonString(lineBuffer, record.message);
+    if (record.truncated) lineBuffer.append(std::string_view(",\"truncated\":true"));
+    lineBuffer.append(std::string_view("}\n"));
+
+    append(std::string_view(lineBuffer.data(), lineBuffer.size()));
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "GLogFileSink.h"
+#include <fmt/format.h>
+#include <string>
+
+// ✅ One JSON object per line for log collectors, buffered and rotated like FileSink:
+// {"ts":1760000000123456789,"time":"2025-10-09T08:53:20.123Z","level":"INFO","thread":1,"file":"main.cpp","line":120,"msg":"..."}
+// The sink's pattern is not used.
+class JsonLinesSink : public FileSink {
+public:
+    using FileSink::FileSink;
+
+    void write(const GLogRecord& record) override;
+
+private:
+    fmt::memory_buffer lineBuffer;
+    int64_t cachedSecond = INT64_MIN;
+    char cachedTime[24] = {}; // "2025-10-09T08:53:20"
+};
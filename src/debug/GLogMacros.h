@@ -1,9 +1,124 @@
 #pragma once
 
 #include "GLog.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
-// ✅ Fix macros to support multiple arguments using `__VA_ARGS__`
-#define GLOG_INFO(...)  GLog::log(GLogLevel::GLOG_INFO, __VA_ARGS__)
-#define GLOG_WARN(...)  GLog::log(GLogLevel::GLOG_WARN, __VA_ARGS__)
-#define GLOG_ERROR(...) GLog::log(GLogLevel::GLOG_ERROR, __VA_ARGS__)
-#define GLOG_DEBUG(...) GLog::log(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+/*
+    ✅ Logging macros
+
+    GLOG_INFO("Loaded {} emojis", count);
+    GLOG_DEBUG_EVERY_N(100, "Frame {}", frame);            // 1st, 101st, 201st... call
+    GLOG_DEBUG_ONCE("First frame rendered");
+    GLOG_WARN_RATE_LIMITED(1000, "Atlas is full");         // At most once per 1000 ms
+    GLOG_DEBUG_BIN("Mixed {} samples in {} us", n, us);   // Deferred formatting, see GLogBinary.h
+
+    Levels below GLOG_ACTIVE_LEVEL compile to nothing (the call is kept
+    behind `if (false)` so it is still type-checked). Enabled levels check
+    GLog::shouldLog() before the arguments are evaluated, so a disabled line
+    only costs one relaxed load. The sampled variants keep their counter or
+    timestamp in a static at each call site and are thread-safe.
+*/
+
+// ✅ Per-call-site state for the *_RATE_LIMITED macros
+class GLogRateLimiter {
+public:
+    bool allow(int64_t intervalMs) {
+        int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t next = nextAllowedMs.load(std::memory_order_relaxed);
+        // Only the thread that moves the deadline forward gets to log
+        return now >= next && nextAllowedMs.compare_exchange_strong(next, now + intervalMs, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> nextAllowedMs{INT64_MIN};
+};
+
+#define GLOG_LOG_AT(level, ...) \
+    do { if (GLog::shouldLog(level)) GLog::log(GLogSourceLocation{__FILE__, __LINE__}, level, __VA_ARGS__); } while (0)
+
+#define GLOG_LOG_EVERY_N(level, n, ...) \
+    do { \
+        static std::atomic<uint32_t> glogCallCount{0}; \
+        if (GLog::shouldLog(level) && glogCallCount.fetch_add(1, std::memory_order_relaxed) % (n) == 0) GLog::log(GLogSourceLocation{__FILE__, __LINE__}, level, __VA_ARGS__); \
+    } while (0)
+
+#define GLOG_LOG_ONCE(level, ...) \
+    do { \
+        static std::atomic<bool> glogLogged{false}; \
+        if (GLog::shouldLog(level) && !glogLogged.exchange(true, std::memory_order_relaxed)) GLog::log(GLogSourceLocation{__FILE__, __LINE__}, level, __VA_ARGS__); \
+    } while (0)
+
+#define GLOG_LOG_RATE_LIMITED(level, intervalMs, ...) \
+    do { \
+        static GLogRateLimiter glogLimiter; \
+        if (GLog::shouldLog(level) && glogLimiter.allow(intervalMs)) GLog::log(GLogSourceLocation{__FILE__, __LINE__}, level, __VA_ARGS__); \
+    } while (0)
+
+#define GLOG_LOG_BINARY(level, ...) \
+    do { \
+        static std::atomic<uint32_t> glogFormatId{0}; \
+        if (GLog::shouldLog(level)) GLog::logBinary(glogFormatId, level, __FILE__, __LINE__, __VA_ARGS__); \
+    } while (0)
+
+// ✅ Never runs and is optimized out, but still type-checks the format string and
+// keeps variables that are only logged from triggering unused warnings
+#define GLOG_DISABLED(level, ...) \
+    do { if (false) GLog::log(level, __VA_ARGS__); } while (0)
+
+#if GLOG_ACTIVE_LEVEL <= GLOG_LEVEL_DEBUG
+    #define GLOG_DEBUG(...) GLOG_LOG_AT(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+    #define GLOG_DEBUG_EVERY_N(n, ...) GLOG_LOG_EVERY_N(GLogLevel::GLOG_DEBUG, n, __VA_ARGS__)
+    #define GLOG_DEBUG_ONCE(...) GLOG_LOG_ONCE(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+    #define GLOG_DEBUG_RATE_LIMITED(intervalMs, ...) GLOG_LOG_RATE_LIMITED(GLogLevel::GLOG_DEBUG, intervalMs, __VA_ARGS__)
+    #define GLOG_DEBUG_BIN(...) GLOG_LOG_BINARY(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+#else
+    #define GLOG_DEBUG(...) GLOG_DISABLED(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+    #define GLOG_DEBUG_EVERY_N(n, ...) GLOG_DISABLED(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+    #define GLOG_DEBUG_ONCE(...) GLOG_DISABLED(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+    #define GLOG_DEBUG_RATE_LIMITED(intervalMs, ...) GLOG_DISABLED(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+    #define GLOG_DEBUG_BIN(...) GLOG_DISABLED(GLogLevel::GLOG_DEBUG, __VA_ARGS__)
+#endif
+
+#if GLOG_ACTIVE_LEVEL <= GLOG_LEVEL_INFO
+    #define GLOG_INFO(...) GLOG_LOG_AT(GLogLevel::GLOG_INFO, __VA_ARGS__)
+    #define GLOG_INFO_EVERY_N(n, ...) GLOG_LOG_EVERY_N(GLogLevel::GLOG_INFO, n, __VA_ARGS__)
+    #define GLOG_INFO_ONCE(...) GLOG_LOG_ONCE(GLogLevel::GLOG_INFO, __VA_ARGS__)
+    #define GLOG_INFO_RATE_LIMITED(intervalMs, ...) GLOG_LOG_RATE_LIMITED(GLogLevel::GLOG_INFO, intervalMs, __VA_ARGS__)
+    #define GLOG_INFO_BIN(...) GLOG_LOG_BINARY(GLogLevel::GLOG_INFO, __VA_ARGS__)
+#else
+    #define GLOG_INFO(...) GLOG_DISABLED(GLogLevel::GLOG_INFO, __VA_ARGS__)
+    #define GLOG_INFO_EVERY_N(n, ...) GLOG_DISABLED(GLogLevel::GLOG_INFO, __VA_ARGS__)
+    #define GLOG_INFO_ONCE(...) GLOG_DISABLED(GLogLevel::GLOG_INFO, __VA_ARGS__)
+    #define GLOG_INFO_RATE_LIMITED(intervalMs, ...) GLOG_DISABLED(GLogLevel::GLOG_INFO, __VA_ARGS__)
+    #define GLOG_INFO_BIN(...) GLOG_DISABLED(GLogLevel::GLOG_INFO, __VA_ARGS__)
+#endif
+
+#if GLOG_ACTIVE_LEVEL <= GLOG_LEVEL_WARN
+    #define GLOG_WARN(...) GLOG_LOG_AT(GLogLevel::GLOG_WARN, __VA_ARGS__)
+    #define GLOG_WARN_EVERY_N(n, ...) GLOG_LOG_EVERY_N(GLogLevel::GLOG_WARN, n, __VA_ARGS__)
+    #define GLOG_WARN_ONCE(...) GLOG_LOG_ONCE(GLogLevel::GLOG_WARN, __VA_ARGS__)
+    #define GLOG_WARN_RATE_LIMITED(intervalMs, ...) GLOG_LOG_RATE_LIMITED(GLogLevel::GLOG_WARN, intervalMs, __VA_ARGS__)
+    #define GLOG_WARN_BIN(...) GLOG_LOG_BINARY(GLogLevel::GLOG_WARN, __VA_ARGS__)
+#else
+    #define GLOG_WARN(...) GLOG_DISABLED(GLogLevel::GLOG_WARN, __VA_ARGS__)
+    #define GLOG_WARN_EVERY_N(n, ...) GLOG_DISABLED(GLogLevel::GLOG_WARN, __VA_ARGS__)
+    #define GLOG_WARN_ONCE(...) GLOG_DISABLED(GLogLevel::GLOG_WARN, __VA_ARGS__)
+    #define GLOG_WARN_RATE_LIMITED(intervalMs, ...) GLOG_DISABLED(GLogLevel::GLOG_WARN, __VA_ARGS__)
+    #define GLOG_WARN_BIN(...) GLOG_DISABLED(GLogLevel::GLOG_WARN, __VA_ARGS__)
+#endif
+
+#if GLOG_ACTIVE_LEVEL <= GLOG_LEVEL_ERROR
+    #define GLOG_ERROR(...) GLOG_LOG_AT(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+    #define GLOG_ERROR_EVERY_N(n, ...) GLOG_LOG_EVERY_N(GLogLevel::GLOG_ERROR, n, __VA_ARGS__)
+    #define GLOG_ERROR_ONCE(...) GLOG_LOG_ONCE(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+    #define GLOG_ERROR_RATE_LIMITED(intervalMs, ...) GLOG_LOG_RATE_LIMITED(GLogLevel::GLOG_ERROR, intervalMs, __VA_ARGS__)
+    #define GLOG_ERROR_BIN(...) GLOG_LOG_BINARY(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+#else
+    #define GLOG_ERROR(...) GLOG_DISABLED(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+    #define GLOG_ERROR_EVERY_N(n, ...) GLOG_DISABLED(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+    #define GLOG_ERROR_ONCE(...) GLOG_DISABLED(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+    #define GLOG_ERROR_RATE_LIMITED(intervalMs, ...) GLOG_DISABLED(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+    #define GLOG_ERROR_BIN(...) GLOG_DISABLED(GLogLevel::GLOG_ERROR, __VA_ARGS__)
+#endif
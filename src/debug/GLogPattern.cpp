@@ -0,0 +1,194 @@
+#include "GLogPattern.h"
+#include <climits>
+
+static std::string_view levelName(GLogLevel level) {
+    switch (level) {
+        case GLogLevel::GLOG_INFO: return "INFO";
+        case GLogLevel::GLOG_WARN: return "WARNING";
+        case GLogLevel::GLOG_ERROR: return "ERROR";
+        case GLogLevel::GLOG_DEBUG: return "DEBUG";
+        default: return "UNKNOWN";
+    }
+}
+
+static std::string_view levelColor(GLogLevel level) {
+    switch (level) {
+        case GLogLevel::GLOG_INFO: return "\033[1;33m";   // Yellow
+        case GLogLevel::GLOG_WARN: return "\033[1;35m";   // Magenta
+        case GLogLevel::GLOG_ERROR: return "\033[1;31m";  // Red
+        case GLogLevel::GLOG_DEBUG: return "\033[1;32m";  // Green
+        default: return "";
+    }
+}
+
+// "src/debug/GLog.cpp" -> "GLog.cpp"
+static std::string_view sourceFileName(const char* path) {
+    if (!path) return "?";
+    std::string_view file(path);
+    size_t slash = file.find_last_of("/\\");
+    return slash == std::string_view::npos ? file : file.substr(slash + 1);
+}
+
+// ✅ Zero-padded fixed-width number without going through fmt's format parser
+template <typename Out>
+static void appendDigits(Out& out, unsigned value, int width) {
+    char digits[10];
+    for (int i = width - 1; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(digits, digits + width);
+}
+
+bool GLogPattern::isTimeField(TokenKind kind) {
+    return kind == TokenKind::Year || kind == TokenKind::Month || kind == TokenKind::Day ||
+           kind == TokenKind::Hour || kind == TokenKind::Minute || kind == TokenKind::Second;
+}
+
+void GLogPattern::compile(const std::string& newPattern) {
+    pattern = newPattern;
+    literals.clear();
+    tokens.clear();
+    runTokens.clear();
+    runCache.clear();
+    cachedSecond = INT64_MIN;
+
+    // ✅ Pass 1: split the pattern into literals and fields
+    std::vector<Token> parsed;
+    auto addLiteral = [&](std::string_view text) {
+        if (!parsed.empty() && parsed.back().kind == TokenKind::Literal) {
+            parsed.back().length += static_cast<uint32_t>(text.size());
+        } else {
+            parsed.push_back(Token{TokenKind::Literal, static_cast<uint32_t>(literals.size()), static_cast<uint32_t>(text.size())});
+        }
+        literals.append(text);
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != '%' || i + 1 == pattern.size()) {
+            addLiteral(std::string_view(&pattern[i], 1));
+            continue;
+        }
+
+        char flag = pattern[++i];
+        TokenKind kind;
+        switch (flag) {
+            case 'Y': kind = TokenKind::Year; break;
+            case 'm': kind = TokenKind::Month; break;
+            case 'd': kind = TokenKind::Day; break;
+            case 'H': kind = TokenKind::Hour; break;
+            case 'M': kind = TokenKind::Minute; break;
+            case 'S': kind = TokenKind::Second; break;
+            case 'e': kind = TokenKind::Millisecond; break;
+            case 'l': kind = TokenKind::Level; break;
+            case 'v': kind = TokenKind::Message; break;
+            case 't': kind = TokenKind::ThreadId; break;
+            case 'n': kind = TokenKind::LoggerName; break;
+            case 's': kind = TokenKind::SourceFile; break;
+            case '#': kind = TokenKind::SourceLine; break;
+            case '^': kind = TokenKind::ColorStart; break;
+            case '$': kind = TokenKind::ColorEnd; break;
+            case '%': addLiteral("%"); continue;
+            default: addLiteral(std::string_view(&pattern[i - 1], 2)); continue; // Unknown flags are kept as text
+        }
+        parsed.push_back(Token{kind});
+    }
+
+    // ✅ Pass 2: fold each run of time fields (and the literals between them) into one cached token
+    for (size_t i = 0; i < parsed.size();) {
+        if (!isTimeField(parsed[i].kind)) {
+            tokens.push_back(parsed[i++]);
+            continue;
+        }
+
+        size_t end = i;
+        size_t lastField = i;
+        while (end < parsed.size() && (isTimeField(parsed[end].kind) || parsed[end].kind == TokenKind::Literal)) {
+            if (isTimeField(parsed[end].kind)) lastField = end;
+            ++end;
+        }
+
+        // Leading literals stay part of the run only if they precede a field; trailing ones are left out
+        Token run{TokenKind::TimeRun, static_cast<uint32_t>(runTokens.size()), static_cast<uint32_t>(lastField + 1 - i),
+                  static_cast<uint32_t>(runCache.size())};
+        runTokens.insert(runTokens.end(), parsed.begin() + i, parsed.begin() + lastField + 1);
+        runCache.emplace_back();
+        tokens.push_back(run);
+        i = lastField + 1;
+    }
+}
+
+void GLogPattern::renderTimeRuns(int64_t seconds) {
+    std::time_t time = static_cast<std::time_t>(seconds);
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+
+    for (const Token& run : tokens) {
+        if (run.kind != TokenKind::TimeRun) continue;
+
+        std::string& text = runCache[run.runIndex];
+        text.clear();
+        for (uint32_t i = run.begin; i < run.begin + run.length; ++i) {
+            const Token& token = runTokens[i];
+            switch (token.kind) {
+                case TokenKind::Literal: text.append(literals, token.begin, token.length); break;
+                case TokenKind::Year: appendDigits(text, static_cast<unsigned>(localTime.tm_year + 1900), 4); break;
+                case TokenKind::Month: appendDigits(text, static_cast<unsigned>(localTime.tm_mon + 1), 2); break;
+                case TokenKind::Day: appendDigits(text, static_cast<unsigned>(localTime.tm_mday), 2); break;
+                case TokenKind::Hour: appendDigits(text, static_cast<unsigned>(localTime.tm_hour), 2); break;
+                case TokenKind::Minute: appendDigits(text, static_cast<unsigned>(localTime.tm_min), 2); break;
+                case TokenKind::Second: appendDigits(text, static_cast<unsigned>(localTime.tm_sec), 2); break;
+                default: break;
+            }
+        }
+    }
+    cachedSecond = seconds;
+}
+
+void GLogPattern::format(fmt::memory_buffer& out, const GLogRecord& record) {
+    // ✅ Floor division so timestamps before the epoch still land in the right second
+    int64_t seconds = record.timestampNs / 1000000000;
+    int64_t remainderNs = record.timestampNs % 1000000000;
+    if (remainderNs < 0) {
+        seconds -= 1;
+        remainderNs += 1000000000;
+    }
+    if (seconds != cachedSecond && !runCache.empty()) renderTimeRuns(seconds);
+
+    for (const Token& token : tokens) {
+        switch (token.kind) {
+            case TokenKind::Literal: out.append(literals.data() + token.begin, literals.data() + token.begin + token.length); break;
+            case TokenKind::TimeRun: {
+                const std::string& text = runCache[token.runIndex];
+                out.append(text.data(), text.data() + text.size());
+                break;
+            }
+            case TokenKind::Millisecond: appendDigits(out, static_cast<unsigned>(remainderNs / 1000000), 3); break;
+            case TokenKind::Level: {
+                std::string_view name = levelName(record.level);
+                out.append(name.data(), name.data() + name.size());
+                break;
+            }
+            case TokenKind::Message: out.append(record.message.data(), record.message.data() + record.message.size()); break;
+            case TokenKind::ThreadId: fmt::format_to(std::back_inserter(out), "{}", record.threadId); break;
+            case TokenKind::LoggerName: out.append(std::string_view("GLog")); break;
+            case TokenKind::SourceFile: {
+                std::string_view file = sourceFileName(record.source.file);
+                out.append(file.data(), file.data() + file.size());
+                break;
+            }
+            case TokenKind::SourceLine: fmt::format_to(std::back_inserter(out), "{}", record.source.line); break;
+            case TokenKind::ColorStart: {
+                std::string_view color = levelColor(record.level);
+                out.append(color.data(), color.data() + color.size());
+                break;
+            }
+            case TokenKind::ColorEnd: out.append(std::string_view("\033[0m")); break;
+            default: break;
+        }
+    }
+}
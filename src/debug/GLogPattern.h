@@ -0,0 +1,71 @@
+#pragma once
+#include "GLogConfig.h"
+#include "GLogRecord.h"
+#include <fmt/format.h>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    ✅ A log pattern compiled into a token program.
+
+    %Y %m %d %H %M %S → Date and time fields
+    %e → Milliseconds
+    %l → Log level
+    %v → Log message
+    %t → Thread ID
+    %n → Logger name
+    %s / %# → Source file name / line of the log call
+    %^ / %$ → Start / reset color
+    %% → A literal '%'
+
+    Runs of date/time fields and the literals between them ("[%Y-%m-%d %H:%M:%S")
+    are rendered once per second and copied for every line after that.
+    Not thread-safe: each sink owns one and GLog calls sinks under its log mutex.
+*/
+class GLogPattern {
+public:
+    GLogPattern() = default;
+    explicit GLogPattern(const std::string& pattern) { compile(pattern); }
+
+    void compile(const std::string& pattern);
+    const std::string& source() const { return pattern; }
+
+    // Appends the formatted line (without newline) to out
+    void format(fmt::memory_buffer& out, const GLogRecord& record);
+
+private:
+    enum class TokenKind : uint8_t {
+        Literal,
+        Year, Month, Day, Hour, Minute, Second,
+        TimeRun, // Cached rendering of a run of time fields and literals
+        Millisecond,
+        Level,
+        Message,
+        ThreadId,
+        LoggerName,
+        SourceFile,
+        SourceLine,
+        ColorStart,
+        ColorEnd
+    };
+
+    struct Token {
+        TokenKind kind;
+        uint32_t begin = 0;    // Literal: offset into literals; TimeRun: first token in runTokens
+        uint32_t length = 0;   // Literal: byte count; TimeRun: token count
+        uint32_t runIndex = 0; // TimeRun: index into runCache
+    };
+
+    static bool isTimeField(TokenKind kind);
+    void renderTimeRuns(int64_t seconds);
+
+    std::string pattern;
+    std::string literals;
+    std::vector<Token> tokens;
+    std::vector<Token> runTokens; // Tokens inside TimeRuns
+    std::vector<std::string> runCache;
+    int64_t cachedSecond = INT64_MIN;
+};
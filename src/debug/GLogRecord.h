@@ -0,0 +1,22 @@
+#pragma once
+#include "GLogConfig.h"
+#include <cstdint>
+#include <string_view>
+
+// ✅ Where a log call came from. file is __FILE__ and lives for the whole program.
+struct GLogSourceLocation {
+    const char* file = nullptr;
+    uint32_t line = 0;
+};
+
+// ✅ One log record as handed to the sinks. Views are only valid during GLogSink::write().
+struct GLogRecord {
+    GLogLevel level;
+    bool truncated;           // The message was cut to fit a ring slot
+    int64_t timestampNs;      // system_clock, nanoseconds since the epoch
+    uint64_t threadId;
+    GLogSourceLocation source;
+    std::string_view message; // Formatted text; empty when only binary sinks take the record
+    uint32_t formatId;        // 0: payload is the message; otherwise encoded arguments, see GLogBinary
+    std::string_view payload;
+};
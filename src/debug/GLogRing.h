@@ -0,0 +1,113 @@
+#pragma once
+#include "GLogConfig.h"
+#include "GLogRecord.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// ✅ One preallocated log record. The producer formats straight into text (or
+// copies the raw arguments for binary records), the worker thread turns it into
+// a line for the sinks.
+struct alignas(64) GLogSlot {
+    std::atomic<size_t> sequence{0}; // Ring protocol state, see GLogRing
+    int64_t timestamp = 0;           // system_clock ns, or GLogClock ticks for binary records
+    uint64_t threadId = 0;
+    GLogSourceLocation source;       // Text records only, binary ones take it from their format
+    uint32_t formatId = 0;           // 0: text is the message; otherwise the encoded arguments, see GLogBinary
+    uint16_t length = 0;
+    GLogLevel level = GLogLevel::GLOG_INFO;
+    bool truncated = false;
+    char text[GLOG_SLOT_SIZE - 48];
+};
+static_assert(sizeof(GLogSlot) == GLOG_SLOT_SIZE, "GLogSlot must fill exactly one slot");
+
+// ✅ Bounded lock-free ring of log slots (Dmitry Vyukov's bounded MPMC queue).
+//
+// Every slot carries a sequence number: equal to the position when the slot is
+// free for that lap, position + 1 once it holds a published record. Producers
+// claim a position with one CAS, fill the slot and publish it with a release
+// store; nothing is allocated and no lock is taken. The worker thread is the
+// normal consumer, but a producer using the drop-oldest policy may also pop
+// (and discard) the oldest record, which is why consumption uses a CAS too.
+class GLogRing {
+public:
+    explicit GLogRing(size_t capacity);
+
+    // Returns a slot to fill and publish(), or nullptr if the ring is full
+    GLogSlot* tryClaim(size_t& outPosition);
+    void publish(GLogSlot* slot, size_t position);
+
+    // Returns the oldest published slot, or nullptr if there is none. The caller
+    // must release() it once the record has been handled.
+    GLogSlot* tryPop(size_t& outPosition);
+    void release(GLogSlot* slot, size_t position);
+
+    size_t capacity() const { return mask + 1; }
+    size_t claimedCount() const { return enqueuePosition.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<GLogSlot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) std::atomic<size_t> dequeuePosition{0};
+};
+
+inline GLogRing::GLogRing(size_t capacity) {
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < capacity) roundedCapacity <<= 1;
+
+    slots.reset(new GLogSlot[roundedCapacity]);
+    mask = roundedCapacity - 1;
+    for (size_t i = 0; i < roundedCapacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+inline GLogSlot* GLogRing::tryClaim(size_t& outPosition) {
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        GLogSlot* slot = &slots[position & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                outPosition = position;
+                return slot;
+            }
+        } else if (difference < 0) {
+            return nullptr; // The slot still holds a record from the previous lap
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+inline void GLogRing::publish(GLogSlot* slot, size_t position) {
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+inline GLogSlot* GLogRing::tryPop(size_t& outPosition) {
+    size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        GLogSlot* slot = &slots[position & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (difference == 0) {
+            if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                outPosition = position;
+                return slot;
+            }
+        } else if (difference < 0) {
+            return nullptr; // Not published yet
+        } else {
+            position = dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+inline void GLogRing::release(GLogSlot* slot, size_t position) {
+    slot->sequence.store(position + mask + 1, std::memory_order_release);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "GLogConfig.h"
+#include "GLogPattern.h"
+#include "GLogRecord.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+
+// ✅ Base class for log outputs. GLog only calls a sink for records at or above its
+// level, and only formats the message if some sink that takes the record needs text.
+// All virtual calls happen under GLog's log mutex.
+class GLogSink {
+public:
+    virtual ~GLogSink() = default;
+
+    virtual void write(const GLogRecord& record) = 0;
+    virtual void flush() {}
+    // ✅ Called by the async worker about every 50 ms, for time-based work like periodic flushes
+    virtual void poll() {}
+    // ✅ Sinks that store binary records as they are return true; record.message is then empty
+    virtual bool acceptsBinary() const { return false; }
+
+    // ✅ Per-sink threshold on top of GLog::setLogLevel, can be changed at any time
+    void setLevel(GLogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    GLogLevel getLevel() const { return minLevel.load(std::memory_order_relaxed); }
+    bool shouldLog(GLogLevel level) const { return static_cast<int>(level) >= static_cast<int>(getLevel()); }
+
+    // ✅ Line pattern for text sinks, see GLogPattern.h. Set it before addSink() or use GLog::setPattern().
+    void setPattern(const std::string& pattern) { linePattern.compile(pattern); }
+
+protected:
+    // The record formatted with this sink's pattern, newline included. Valid until the next call.
+    std::string_view formatLine(const GLogRecord& record) {
+        lineBuffer.clear();
+        linePattern.format(lineBuffer, record);
+        lineBuffer.push_back('\n');
+        return std::string_view(lineBuffer.data(), lineBuffer.size());
+    }
+
+private:
+    std::atomic<GLogLevel> minLevel{GLogLevel::GLOG_DEBUG};
+    GLogPattern linePattern{"[%Y-%m-%d %H:%M:%S] [%l] %v"};
+    fmt::memory_buffer lineBuffer;
+};
@@ -36,7 +36,7 @@ std::string logLevelToString(GLogLevel level) {
 }
 
 bool shouldLog(GLogLevel level) {
-    return static_cast<int>(level) >= static_cast<int>(CURRENT_LOG_LEVEL);
+    return static_cast<int>(level) >= static_cast<int>(CURRENT_LOG_LEVEL.load(std::memory_order_relaxed));
 }
 
 void setConsoleColor(GLogLevel level) {
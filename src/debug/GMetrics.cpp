@@ -0,0 +1,215 @@
+#include "GMetrics.h"
+#include "GLogMacros.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fmt/format.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    struct MetricEntry {
+        std::string name;
+        GMetricType type;
+        std::unique_ptr<GMetricCounter> counter;
+        std::unique_ptr<GMetricGauge> gauge;
+        std::unique_ptr<GMetricHistogram> histogram;
+        std::function<double()> sample; // Sampled gauges only
+    };
+
+    // Function-local so metrics can be registered from static initializers
+    struct Registry {
+        std::mutex mutex;
+        std::deque<MetricEntry> entries; // Deque: references stay valid as it grows
+    };
+
+    Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    std::mutex dumpMutex;
+    std::condition_variable dumpWake;
+    std::thread dumpThread;
+    bool dumpStopping = false;
+}
+
+// ✅ Finds or creates the entry; a name registered with another type is an error
+static MetricEntry* FindOrAdd(std::string_view name, GMetricType type) {
+    Registry& registry = GetRegistry();
+    for (MetricEntry& entry : registry.entries) {
+        if (entry.name != name) continue;
+        if (entry.type != type) {
+            GLOG_ERROR("Metric {} is already registered with another type.", name);
+            return nullptr;
+        }
+        return &entry;
+    }
+
+    MetricEntry& entry = registry.entries.emplace_back();
+    entry.name = std::string(name);
+    entry.type = type;
+    if (type == GMetricType::Counter) entry.counter = std::make_unique<GMetricCounter>();
+    if (type == GMetricType::Gauge) entry.gauge = std::make_unique<GMetricGauge>();
+    if (type == GMetricType::Histogram) entry.histogram = std::make_unique<GMetricHistogram>();
+    return &entry;
+}
+
+GMetricCounter& GMetrics::counter(std::string_view name) {
+    static GMetricCounter unregistered;
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    MetricEntry* entry = FindOrAdd(name, GMetricType::Counter);
+    return entry ? *entry->counter : unregistered;
+}
+
+GMetricGauge& GMetrics::gauge(std::string_view name) {
+    static GMetricGauge unregistered;
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    MetricEntry* entry = FindOrAdd(name, GMetricType::Gauge);
+    return entry ? *entry->gauge : unregistered;
+}
+
+GMetricHistogram& GMetrics::histogram(std::string_view name) {
+    static GMetricHistogram unregistered;
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    MetricEntry* entry = FindOrAdd(name, GMetricType::Histogram);
+    return entry ? *entry->histogram : unregistered;
+}
+
+void GMetrics::sampledGauge(std::string_view name, std::function<double()> sample) {
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    MetricEntry* entry = FindOrAdd(name, GMetricType::Gauge);
+    if (entry) entry->sample = std::move(sample);
+}
+
+void GMetrics::sampleGauges() {
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    for (MetricEntry& entry : GetRegistry().entries) {
+        if (entry.sample) entry.gauge->set(entry.sample());
+    }
+}
+
+std::vector<GMetricInfo> GMetrics::list() {
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    std::vector<GMetricInfo> metrics;
+    metrics.reserve(GetRegistry().entries.size());
+    for (MetricEntry& entry : GetRegistry().entries) {
+        if (entry.sample) entry.gauge->set(entry.sample());
+        metrics.push_back(GMetricInfo{entry.name, entry.type, entry.counter.get(), entry.gauge.get(), entry.histogram.get()});
+    }
+    return metrics;
+}
+
+size_t GMetricHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+    uint32_t highestBit = 63;
+    while (!(value >> highestBit)) --highestBit;
+    uint32_t shift = highestBit - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift + 1) * SUB_BUCKETS + static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t GMetricHistogram::bucketLowerBound(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+    uint32_t shift = static_cast<uint32_t>(index / SUB_BUCKETS) - 1;
+    return (static_cast<uint64_t>(SUB_BUCKETS) + index % SUB_BUCKETS) << shift;
+}
+
+GMetricHistogramSnapshot GMetricHistogram::snapshot() const {
+    // Not atomic as a whole: a record that races the copy may show in count but not yet in its bucket
+    GMetricHistogramSnapshot result;
+    result.counts.resize(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) result.counts[i] = buckets[i].load(std::memory_order_relaxed);
+    result.count = count.load(std::memory_order_relaxed);
+    result.sum = sum.load(std::memory_order_relaxed);
+    return result;
+}
+
+uint64_t GMetricHistogramSnapshot::percentile(double percent) const {
+    uint64_t total = 0;
+    for (uint64_t bucketCount : counts) total += bucketCount;
+    if (total == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return GMetricHistogram::bucketUpperBound(i);
+    }
+    return GMetricHistogram::bucketUpperBound(counts.size() - 1);
+}
+
+GMetricHistogramSnapshot GMetricHistogramSnapshot::since(const GMetricHistogramSnapshot& earlier) const {
+    GMetricHistogramSnapshot window = *this;
+    if (earlier.counts.size() != counts.size()) return window;
+    for (size_t i = 0; i < counts.size(); ++i) window.counts[i] -= earlier.counts[i];
+    window.count -= earlier.count;
+    window.sum -= earlier.sum;
+    return window;
+}
+
+static void DumpLoop(std::string path, uint32_t intervalMs) {
+    std::ofstream file(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!file.is_open()) {
+        GLOG_ERROR("Failed to open metrics file: {}", path);
+        return;
+    }
+
+    std::unordered_map<std::string_view, GMetricHistogramSnapshot> previous;
+    fmt::memory_buffer line;
+    std::unique_lock<std::mutex> lock(dumpMutex);
+    while (!dumpStopping) {
+        dumpWake.wait_for(lock, std::chrono::milliseconds(intervalMs), [] { return dumpStopping; });
+
+        // {"ts":<unix ms>,"counters":{...},"gauges":{...},"histograms":{"name":{"count":..,"mean":..,"p50":..,"p95":..,"p99":..}}}
+        std::vector<GMetricInfo> metrics = GMetrics::list();
+        line.clear();
+        fmt::format_to(std::back_inserter(line), "{{\"ts\":{}",
+                       std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        for (GMetricType type : {GMetricType::Counter, GMetricType::Gauge, GMetricType::Histogram}) {
+            const char* section = type == GMetricType::Counter ? "counters" : type == GMetricType::Gauge ? "gauges" : "histograms";
+            fmt::format_to(std::back_inserter(line), ",\"{}\":{{", section);
+            bool first = true;
+            for (const GMetricInfo& metric : metrics) {
+                if (metric.type != type) continue;
+                fmt::format_to(std::back_inserter(line), "{}\"{}\":", first ? "" : ",", metric.name);
+                first = false;
+                if (type == GMetricType::Counter) {
+                    fmt::format_to(std::back_inserter(line), "{}", metric.counter->get());
+                } else if (type == GMetricType::Gauge) {
+                    fmt::format_to(std::back_inserter(line), "{}", metric.gauge->get());
+                } else {
+                    GMetricHistogramSnapshot current = metric.histogram->snapshot();
+                    GMetricHistogramSnapshot window = current.since(previous[metric.name]);
+                    fmt::format_to(std::back_inserter(line), "{{\"count\":{},\"mean\":{:.1f},\"p50\":{},\"p95\":{},\"p99\":{}}}",
+                                   window.count, window.mean(), window.percentile(50), window.percentile(95), window.percentile(99));
+                    previous[metric.name] = std::move(current);
+                }
+            }
+            line.push_back('}');
+        }
+        line.append(std::string_view("}\n"));
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        file.flush();
+    }
+}
+
+void GMetrics::startPeriodicDump(const std::string& path, uint32_t intervalMs) {
+    stopPeriodicDump();
+    dumpStopping = false;
+    dumpThread = std::thread(DumpLoop, path, intervalMs);
+    GLOG_INFO("Writing metrics to {} every {} ms.", path, intervalMs);
+}
+
+void GMetrics::stopPeriodicDump() {
+    if (!dumpThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        dumpStopping = true;
+    }
+    dumpWake.notify_one();
+    dumpThread.join();
+}
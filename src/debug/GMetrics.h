@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+inline uint32_t METRICS_DUMP_INTERVAL_MS = 1000; // Periodic dump, see GMetrics::startPeriodicDump
+
+// ✅ Monotonic count, consumers turn it into a rate by diffing two reads
+class GMetricCounter {
+public:
+    void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+// ✅ Last value wins
+class GMetricGauge {
+public:
+    void set(double newValue) { value.store(newValue, std::memory_order_relaxed); }
+    double get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value{0.0};
+};
+
+// ✅ Counts of a histogram at one point in time; since() gives the window between two
+struct GMetricHistogramSnapshot {
+    std::vector<uint64_t> counts; // By bucket, see GMetricHistogram
+    uint64_t count = 0;
+    uint64_t sum = 0;
+
+    uint64_t percentile(double percent) const; // Upper bound of the bucket, 0 when empty
+    double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    GMetricHistogramSnapshot since(const GMetricHistogramSnapshot& earlier) const;
+};
+
+// ✅ HDR-style log-linear buckets: exact below 16, then 16 buckets per power of two,
+// so every value is known to within 1/16 (about 6%). Recording is three relaxed adds (bucket, count, sum).
+class GMetricHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 4;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value) {
+        buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+    }
+    GMetricHistogramSnapshot snapshot() const;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index) { return index + 1 < BUCKET_COUNT ? bucketLowerBound(index + 1) - 1 : UINT64_MAX; }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+};
+
+enum class GMetricType : uint8_t { Counter, Gauge, Histogram };
+
+// ✅ Names come from the registry and live as long as the program
+struct GMetricInfo {
+    std::string_view name;
+    GMetricType type;
+    const GMetricCounter* counter;
+    const GMetricGauge* gauge;
+    const GMetricHistogram* histogram;
+};
+
+// ✅ Process-wide registry of named metrics. Lookups take a lock, so callers keep the
+// reference (metrics are never removed); updates after that are lock-free:
+//     static GMetricCounter& misses = GMetrics::counter("emoji.texture_misses");
+//     misses.add();
+class GMetrics {
+public:
+    static GMetricCounter& counter(std::string_view name);
+    static GMetricGauge& gauge(std::string_view name);
+    static GMetricHistogram& histogram(std::string_view name);
+
+    // ✅ Gauge whose value is read from `sample` whenever it is listed or sampleGauges() runs.
+    // `sample` can run on any thread that reads the registry, so it may only touch thread-safe state.
+    static void sampledGauge(std::string_view name, std::function<double()> sample);
+    static void sampleGauges(); // ✅ Refreshes the sampled gauges without listing, for readers that keep references
+
+    // ✅ Registration order; sampled gauges are refreshed first
+    static std::vector<GMetricInfo> list();
+
+    // ✅ Appends one JSON line per interval to `path` from a background thread, for headless
+    // runs. Histograms hold the values recorded since the previous line.
+    static void startPeriodicDump(const std::string& path, uint32_t intervalMs = METRICS_DUMP_INTERVAL_MS);
+    static void stopPeriodicDump();
+};
@@ -0,0 +1,191 @@
+#include "GTrace.h"
+#include "GLogMacros.h"
+#include <chrono>
+#include <fmt/format.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> GTrace::enabled{false};
+
+// ✅ Single producer (the owning thread), single consumer (dump() under registryMutex)
+struct GTraceThreadBuffer {
+    explicit GTraceThreadBuffer(uint32_t threadId)
+        : events(new GTraceEvent[GTRACE_BUFFER_EVENTS]), mask(GTRACE_BUFFER_EVENTS - 1), threadId(threadId) {}
+
+    void push(const GTraceEvent& event) {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) > mask) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[position & mask] = event;
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    std::unique_ptr<GTraceEvent[]> events;
+    uint64_t mask;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    uint32_t threadId;
+    std::string threadName; // Guarded by registryMutex
+};
+
+static std::mutex registryMutex;
+static std::vector<std::shared_ptr<GTraceThreadBuffer>> threadBuffers;
+static uint32_t nextThreadId = 1;
+static uint64_t droppedTotal = 0; // Of drained buffers, guarded by registryMutex
+static const uint64_t epochTicks = GTrace::now(); // Paired with epochNs to convert ticks in dump()
+static const int64_t epochNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+// ✅ Created on the thread's first event; the registry keeps it past thread exit until drained
+static GTraceThreadBuffer& LocalBuffer() {
+    thread_local std::shared_ptr<GTraceThreadBuffer> buffer;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer = std::make_shared<GTraceThreadBuffer>(nextThreadId++);
+        threadBuffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void GTrace::setEnabled(bool enable) {
+    if ((GTRACE_BUFFER_EVENTS & (GTRACE_BUFFER_EVENTS - 1)) != 0) {
+        GLOG_ERROR("GTRACE_BUFFER_EVENTS must be a power of two, tracing stays off.");
+        return;
+    }
+    enabled.store(enable, std::memory_order_relaxed);
+    GLOG_INFO("Tracing {}.", enable ? "enabled" : "disabled");
+}
+
+void GTrace::setThreadName(const std::string& name) {
+    GTraceThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.threadName = name;
+}
+
+void GTrace::recordZone(const char* name, uint64_t startTicks, uint64_t endTicks) {
+    GTraceEvent event;
+    event.name = name;
+    event.startTicks = startTicks;
+    event.durationTicks = endTicks - startTicks;
+    event.type = GTraceEventType::Zone;
+    LocalBuffer().push(event);
+}
+
+void GTrace::recordCounter(const char* name, double value) {
+    GTraceEvent event;
+    event.name = name;
+    event.startTicks = now();
+    event.value = value;
+    event.type = GTraceEventType::Counter;
+    LocalBuffer().push(event);
+}
+
+static uint64_t DroppedCountLocked() {
+    uint64_t dropped = droppedTotal;
+    for (const auto& buffer : threadBuffers) dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+uint64_t GTrace::getDroppedCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return DroppedCountLocked();
+}
+
+static void AppendJsonString(fmt::memory_buffer& out, const char* text) {
+    out.push_back('"');
+    for (; *text; ++text) {
+        unsigned char c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(*text);
+        } else if (c < 0x20) {
+            fmt::format_to(std::back_inserter(out), "\\u{:04x}", c);
+        } else {
+            out.push_back(*text);
+        }
+    }
+    out.push_back('"');
+}
+
+
+bool GTrace::dump(const std::string& path) {
+    std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open()) {
+        GLOG_ERROR("Failed to open trace file: {}", path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // ✅ Tick rate measured over the whole run; trace-event timestamps are microseconds
+    uint64_t dumpTicks = now();
+    int64_t dumpNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    double microsPerTick = dumpTicks > epochTicks && dumpNs > epochNs
+        ? static_cast<double>(dumpNs - epochNs) / static_cast<double>(dumpTicks - epochTicks) / 1000.0
+        : 0.001;
+    auto toMicros = [&](int64_t ticks) { return static_cast<double>(ticks) * microsPerTick; };
+
+    fmt::memory_buffer out;
+    size_t eventCount = 0;
+    bool first = true;
+    auto separator = [&] {
+        out.append(std::string_view(first ? "\n" : ",\n"));
+        first = false;
+    };
+
+    out.append(std::string_view("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    for (const auto& buffer : threadBuffers) {
+        separator();
+        fmt::format_to(std::back_inserter(out), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", buffer->threadId);
+        std::string name = buffer->threadName.empty() ? fmt::format("thread {}", buffer->threadId) : buffer->threadName;
+        AppendJsonString(out, name.c_str());
+        out.append(std::string_view("}}"));
+
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i < head; ++i) {
+            const GTraceEvent& event = buffer->events[i & buffer->mask];
+            separator();
+            out.append(std::string_view("{\"name\":"));
+            AppendJsonString(out, event.name);
+            if (event.type == GTraceEventType::Zone) {
+                fmt::format_to(std::back_inserter(out), ",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                               buffer->threadId, toMicros(static_cast<int64_t>(event.startTicks - epochTicks)), toMicros(static_cast<int64_t>(event.durationTicks)));
+            } else {
+                fmt::format_to(std::back_inserter(out), ",\"ph\":\"C\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"args\":{{\"value\":{}}}}}",
+                               buffer->threadId, toMicros(static_cast<int64_t>(event.startTicks - epochTicks)), event.value);
+            }
+            ++eventCount;
+
+            // Keep the memory bounded on long captures
+            if (out.size() >= 1024 * 1024) {
+                file.write(out.data(), static_cast<std::streamsize>(out.size()));
+                out.clear();
+            }
+        }
+        buffer->tail.store(head, std::memory_order_release);
+    }
+    out.append(std::string_view("\n]}\n"));
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+    // ✅ Forget drained buffers of threads that have exited
+    for (auto it = threadBuffers.begin(); it != threadBuffers.end();) {
+        if (it->use_count() == 1 && (*it)->head.load(std::memory_order_acquire) == (*it)->tail.load(std::memory_order_relaxed)) {
+            droppedTotal += (*it)->dropped.load(std::memory_order_relaxed);
+            it = threadBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (!file) {
+        GLOG_ERROR("Failed to write trace file: {}", path);
+        return false;
+    }
+    GLOG_INFO("Wrote {} trace events to {} ({} dropped so far).", eventCount, path, DroppedCountLocked());
+    return true;
+}
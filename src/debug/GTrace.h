@@ -0,0 +1,75 @@
+#pragma once
+#include "GLogBinary.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// ✅ Compile-time switch: with GTRACE_ENABLED 0 the TRACE_* macros expand to nothing
+#ifndef GTRACE_ENABLED
+    #define GTRACE_ENABLED 1
+#endif
+
+inline size_t GTRACE_BUFFER_EVENTS = 65536; // Per thread, power of two. Events past it are dropped until the next dump.
+
+enum class GTraceEventType : uint8_t { Zone, Counter };
+
+struct GTraceEvent {
+    const char* name; // Must outlive the trace: string literals or __func__
+    uint64_t startTicks; // GLogClock ticks, converted to time by dump()
+    union {
+        uint64_t durationTicks; // Zone
+        double value;           // Counter
+    };
+    GTraceEventType type;
+};
+
+// ✅ Scoped zones and counters written to the Chrome trace-event JSON format
+// (chrome://tracing, ui.perfetto.dev). Every thread records into its own
+// single-producer ring, no locks on the hot path; dump() drains the rings.
+// While disabled a zone costs one relaxed atomic load.
+class GTrace {
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // ✅ Shown as the track name, call once from the thread itself
+    static void setThreadName(const std::string& name);
+
+    // ✅ Writes everything recorded since the last dump and empties the buffers
+    static bool dump(const std::string& path);
+    static uint64_t getDroppedCount();
+
+    static uint64_t now() { return GLogClock::ticks(); }
+    static void recordZone(const char* name, uint64_t startTicks, uint64_t endTicks);
+    static void recordCounter(const char* name, double value);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+// ✅ RAII zone, use through TRACE_SCOPE
+class GTraceZone {
+public:
+    explicit GTraceZone(const char* name) : name(GTrace::isEnabled() ? name : nullptr), startTicks(this->name ? GTrace::now() : 0) {}
+    ~GTraceZone() {
+        if (name) GTrace::recordZone(name, startTicks, GTrace::now());
+    }
+
+    GTraceZone(const GTraceZone&) = delete;
+    GTraceZone& operator=(const GTraceZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t startTicks;
+};
+
+#define GTRACE_CONCAT_INNER(a, b) a##b
+#define GTRACE_CONCAT(a, b) GTRACE_CONCAT_INNER(a, b)
+
+#if GTRACE_ENABLED
+    #define TRACE_SCOPE(name) GTraceZone GTRACE_CONCAT(gtraceZone, __LINE__)(name)
+    #define TRACE_COUNTER(name, value) do { if (GTrace::isEnabled()) GTrace::recordCounter(name, static_cast<double>(value)); } while (0)
+#else
+    #define TRACE_SCOPE(name) do {} while (0)
+    #define TRACE_COUNTER(name, value) do { if (false) (void)(value); } while (0)
+#endif
@@ -1,7 +1,11 @@
 #include <glad/glad.h>
 #include "EmojiManager.h"
+#include "EmojiSearch.h"
+#include "EmojiUsage.h"
 #include "Interface.h"
-#include "Utils.h"
+#include "PerfOverlay.h"
+#include "RenderScheduler.h"
+#include "FramePacer.h"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -9,10 +13,15 @@
 #include "debug/GLog.h" // Ensure the correct header file for GLog is included
 #include "debug/GLogMacros.h" // Include macros if required for GLog functionality
 #include "debug/GLogMacros.h"
+#include "debug/GTrace.h"
+#include "debug/GAllocCounter.h"
+#include "debug/GAllocProfiler.h"
+#include "debug/GMetrics.h"
+#include "utils/FrameArena.h"
+#include <cstdlib>
 #include <filesystem>
 #include <thread>
 #include <chrono>
-#include <atomic>
 
 void glfw_error_callback(int error, const char* description)
 {
@@ -22,28 +31,103 @@ void glfw_error_callback(int error, const char* description)
 // Static variables to track window state
 static bool isWindowMoving = false;
 static bool isWindowFocused = true; // Track if the window is focused
-static std::atomic<bool> isIdle(false); // Use atomic for thread-safe idle state
+static FramePacer framePacer;
 
 // Free function for window position callback
 void WindowPosCallback(GLFWwindow*, int, int)
 {
     isWindowMoving = true;
-    GLOG_DEBUG("Window is moving.");
+    GLOG_DEBUG_RATE_LIMITED(1000, "Window is moving.");
+}
+
+// Free function for content scale callback, e.g. when the window moves to a monitor with another DPI
+void WindowContentScaleCallback(GLFWwindow*, float xscale, float)
+{
+    EmojiManager::SetDisplayScale(xscale);
+    RenderScheduler::RequestRedraw();
+}
+
+// Writes what was traced since the last dump to trace_<unix time>.json, open it in ui.perfetto.dev or chrome://tracing
+static void DumpTrace()
+{
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    GTrace::dump("trace_" + std::to_string(seconds) + ".json");
+}
+
+// Writes the allocation profile to allocations_<unix time>.txt, see GAllocProfiler
+static void DumpAllocationReport()
+{
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string path = "allocations_" + std::to_string(seconds) + ".txt";
+    if (GAllocProfiler::writeReport(path)) GLOG_INFO("Allocation report written to {}.", path);
 }
 
 // Free function for window focus callback
 void WindowFocusCallback(GLFWwindow*, int focused)
 {
     isWindowFocused = (focused == GLFW_TRUE);
+    framePacer.setFocused(isWindowFocused); // Background windows drop to the low-power rate
+    RenderScheduler::NotifyInput(); // Redraw focus-dependent styling
     if (isWindowFocused) {
         isWindowMoving = false; // Reset moving state when the window regains focus
         GLOG_DEBUG("Window regained focus. Resetting isWindowMoving.");
     }
 }
 
+// LMS_IDLE_BENCH=<seconds>: once the startup frames are done, counts the frames rendered while
+// nobody touches the window, logs the rate and quits. An idle client should render none.
+static std::thread StartIdleBenchmark(GLFWwindow* window, double seconds)
+{
+    return std::thread([window, seconds] {
+        std::this_thread::sleep_for(std::chrono::duration<double>(RenderScheduler::INPUT_BURST_SECONDS + 0.5));
+        uint64_t startFrames = RenderScheduler::GetFrameCount();
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        uint64_t frames = RenderScheduler::GetFrameCount() - startFrames;
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        GLOG_INFO("Idle benchmark: {} frames in {:.1f} s ({:.2f} FPS).", frames, elapsed, frames / elapsed);
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+        glfwPostEmptyEvent();
+    });
+}
+
+// LMS_ALLOC_CHECK=<frames>: renders continuously and, after a warm-up, expects that many frames
+// to make no heap allocation on any thread. Every frame that allocates is logged and the process
+// exits with 1, so it can run as a test. Needs a build with LMS_COUNT_ALLOCATIONS.
+struct AllocationCheck {
+    static const uint64_t WARMUP_FRAMES = 120;
+
+    bool active = false;
+    uint64_t warmupLeft = WARMUP_FRAMES;
+    uint64_t framesLeft = 0;
+    uint64_t failedFrames = 0;
+
+    void endFrame(GLFWwindow* window, uint64_t frameAllocations)
+    {
+        if (!active) return;
+        RenderScheduler::RequestRedraw(); // Keep frames coming without input
+        if (warmupLeft > 0) {
+            warmupLeft--;
+            return;
+        }
+        if (frameAllocations > 0) {
+            failedFrames++;
+            GLOG_ERROR("Allocation check: steady-state frame made {} heap allocations.", frameAllocations);
+        }
+        if (--framesLeft == 0) {
+            GLOG_INFO("Allocation check: {} of the checked frames allocated.", failedFrames);
+            active = false;
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+    }
+};
+
 int main()
 {
     GLog::init("logs.txt");
+    GTrace::setThreadName("main");
+    if (std::getenv("LMS_TRACE")) GTrace::setEnabled(true); // Also captures startup, F9 toggles it later
+    if (const char* metricsPath = std::getenv("LMS_METRICS")) GMetrics::startPeriodicDump(metricsPath); // Headless runs, F10 shows them in-app
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit()) {
         GLOG_ERROR("Failed to initialize GLFW.");
@@ -60,7 +144,13 @@ int main()
         return -1;
     }
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+
+    // Paced to the monitor refresh with vsync by default; LMS_FPS=<rate> caps it, LMS_VSYNC=0 paces with timers
+    if (const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor())) framePacer.setRefreshRate(mode->refreshRate);
+    if (const char* fps = std::getenv("LMS_FPS")) framePacer.setTargetFps(std::atof(fps));
+    if (const char* vsync = std::getenv("LMS_VSYNC")) framePacer.setVsync(std::atoi(vsync) != 0);
+    int appliedSwapInterval = framePacer.swapInterval();
+    glfwSwapInterval(appliedSwapInterval);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         GLOG_ERROR("Failed to initialize OpenGL loader.");
@@ -73,88 +163,138 @@ int main()
     (void)io;
 
     ImGui::StyleColorsDark();
+    RenderScheduler::Init(window); // Before the ImGui backend, which chains onto its callbacks
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
     // Load emoji metadata
+    float contentScale = 1.0f;
+    glfwGetWindowContentScale(window, &contentScale, nullptr);
+    EmojiManager::SetDisplayScale(contentScale);
+    EmojiManager::SetRedrawCallback(RenderScheduler::RequestRedraw); // Decoded emojis wake the loop to be drawn
     EmojiManager::LoadEmojiMetadata("assets/emojis/openmoji.json");
-
-    const double idleThreshold = 1.0; // 1 second of inactivity to consider idle
-    double lastInteractionTime = glfwGetTime();
+    EmojiUsage::Load("emoji_usage.txt");
+    EmojiSearch::BuildIndex();
+    EmojiManager::PreloadFrequentlyUsedEmojis();
+    EmojiManager::LogMetadataMemoryReport();
 
     // Set GLFW callbacks
     glfwSetWindowPosCallback(window, WindowPosCallback);
     glfwSetWindowFocusCallback(window, WindowFocusCallback);
+    glfwSetWindowContentScaleCallback(window, WindowContentScaleCallback);
 
-    GLOG_INFO("Starting main loop.");
-    while (!glfwWindowShouldClose(window))
-    {
-        // Use glfwWaitEventsTimeout to reduce CPU usage during idle
-        glfwWaitEventsTimeout(0.01);
+    // Published every frame for the performance overlay and the metrics dump
+    GMetricHistogram& cpuFrameTime = GMetrics::histogram("frame.cpu_ns");
+    GMetricHistogram& presentTime = GMetrics::histogram("frame.present_ns");
+    GMetricHistogram& frameAllocations = GMetrics::histogram("frame.allocations");
+    GMetricHistogram& frameAllocatedBytes = GMetrics::histogram("frame.allocated_bytes");
+    std::chrono::steady_clock::time_point lastPresent;
+    GAllocStats lastAllocations = GAllocCounter::get();
 
-        // Detect idle state
-        double currentTime = glfwGetTime();
-        if (currentTime - lastInteractionTime > idleThreshold) {
-            isIdle = true;
+    AllocationCheck allocationCheck;
+    if (const char* checkFrames = std::getenv("LMS_ALLOC_CHECK")) {
+        allocationCheck.framesLeft = std::strtoull(checkFrames, nullptr, 10);
+        allocationCheck.active = GAllocCounter::isEnabled() && allocationCheck.framesLeft > 0;
+        if (!GAllocCounter::isEnabled()) {
+            GLOG_ERROR("LMS_ALLOC_CHECK needs a build with LMS_COUNT_ALLOCATIONS.");
+            allocationCheck.failedFrames = 1;
         }
+    }
 
-        // Reset idle state on interaction
-        if (ImGui::GetIO().WantCaptureMouse || ImGui::GetIO().WantCaptureKeyboard) {
-            isIdle = false;
-            isWindowMoving = false; // Reset moving state on interaction
-            lastInteractionTime = currentTime;
-            GLOG_DEBUG("User interaction detected. Resetting idle and moving states.");
-        }
+    std::thread idleBenchmark;
+    if (const char* benchSeconds = std::getenv("LMS_IDLE_BENCH")) idleBenchmark = StartIdleBenchmark(window, std::atof(benchSeconds));
 
-        // Debug log for state tracking
-        GLOG_DEBUG("isIdle: {}, isWindowMoving: {}, isWindowFocused: {}", isIdle.load(), isWindowMoving, isWindowFocused);
+    GLOG_INFO("Starting main loop.");
+    // Sleeps until input or a RequestRedraw() from a subsystem, so an untouched window costs no CPU
+    while (RenderScheduler::WaitForFrame())
+    {
+        TRACE_SCOPE("Frame");
 
-        // Skip rendering if the window is not focused
-        if (!isWindowFocused) {
-            GLOG_DEBUG("Window not focused. Skipping rendering.");
-            continue;
-        }
+        // Debug log for state tracking, sampled: this runs every frame
+        GLOG_DEBUG_RATE_LIMITED(1000, "isWindowMoving: {}, isWindowFocused: {}", isWindowMoving, isWindowFocused);
 
+        auto frameStart = std::chrono::steady_clock::now();
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        // Example interaction: Reset idle state when a button is pressed
-        if (ImGui::Button("Reset Idle State")) {
-            isIdle = false;
-            isWindowMoving = false; // Reset moving state
-            lastInteractionTime = currentTime;
-            GLOG_DEBUG("Reset Idle State button pressed.");
+        // F9 starts a trace capture, pressing it again writes the trace file
+        if (ImGui::IsKeyPressed(ImGuiKey_F9, false)) {
+            bool tracing = !GTrace::isEnabled();
+            GTrace::setEnabled(tracing);
+            if (!tracing) DumpTrace();
         }
 
+        // F10 shows or hides the performance overlay, F11 writes an allocation report in profiling builds
+        if (ImGui::IsKeyPressed(ImGuiKey_F10, false)) PerfOverlay::ToggleVisible();
+        if (ImGui::IsKeyPressed(ImGuiKey_F11, false)) DumpAllocationReport();
+
         Interface::RenderMainWindow();
+        PerfOverlay::Render();
         Interface::RenderEmojiBrowser();
 
-        // Clear unused textures periodically to free memory
-        static int frameCount = 0;
-        if (++frameCount % 300 == 0) {
-            GLOG_DEBUG("Clearing unused textures.");
-            EmojiManager::ClearUnusedTextures();
+        // Evict emojis that have not been drawn for a while once over the texture budget
+        EmojiManager::EndFrame();
+        if (GTrace::isEnabled()) {
+            TextureResidencyStats textureStats = EmojiManager::GetTextureStats();
+            TRACE_COUNTER("EmojiTextureBytes", textureStats.bytesResident);
+            TRACE_COUNTER("EmojiTextureMisses", textureStats.misses);
         }
 
         // Render
-        ImGui::Render();
-        int display_w, display_h;
-        glfwGetFramebufferSize(window, &display_w, &display_h);
-        glViewport(0, 0, display_w, display_h);
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-        glfwSwapBuffers(window);
-
-        // Limit frame rate
-        Utils::LimitFrameRate(60);
+        {
+            TRACE_SCOPE("Render");
+            ImGui::Render();
+            FrameArena::get().reset(); // The draw lists hold copies of everything the frame's scratch data described
+            int display_w, display_h;
+            glfwGetFramebufferSize(window, &display_w, &display_h);
+            glViewport(0, 0, display_w, display_h);
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        // CPU time excludes the swap, which blocks on vsync
+        auto cpuEnd = std::chrono::steady_clock::now();
+        cpuFrameTime.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(cpuEnd - frameStart).count()));
+
+        {
+            TRACE_SCOPE("SwapBuffers");
+            glfwSwapBuffers(window);
+        }
+        auto present = std::chrono::steady_clock::now();
+        // The first frame after an idle wait follows a gap, not a slow frame
+        if (lastPresent.time_since_epoch().count() != 0 && !RenderScheduler::ResumedFromIdle()) {
+            presentTime.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(present - lastPresent).count()));
+        }
+        lastPresent = present;
+        GAllocStats allocations = GAllocCounter::get();
+        frameAllocations.record(allocations.allocations - lastAllocations.allocations);
+        frameAllocatedBytes.record(allocations.bytes - lastAllocations.bytes);
+        allocationCheck.endFrame(window, allocations.allocations - lastAllocations.allocations);
+        lastAllocations = allocations;
+
+        // Wait for the next frame's deadline; with vsync the swap already waited and the pacer only measures
+        if (RenderScheduler::ResumedFromIdle()) framePacer.reset();
+        framePacer.waitForNextFrame();
+        int swapInterval = framePacer.swapInterval();
+        if (swapInterval != appliedSwapInterval) {
+            glfwSwapInterval(swapInterval);
+            appliedSwapInterval = swapInterval;
+        }
     }
 
     GLOG_INFO("Exiting main loop. Cleaning up resources.");
+    const FramePacerStats& pacing = framePacer.stats();
+    GLOG_INFO("Frame pacing: {} frames, {} missed deadlines, {:.2f} ms average lateness ({:.2f} ms max).",
+              pacing.frames, pacing.missedDeadlines, pacing.averageLatenessMs, pacing.maxLatenessMs);
+    if (idleBenchmark.joinable()) idleBenchmark.join();
+    if (GTrace::isEnabled()) DumpTrace();
+    if (GAllocProfiler::isEnabled()) DumpAllocationReport();
+    GMetrics::stopPeriodicDump();
     // Cleanup
+    EmojiUsage::Save();
     EmojiManager::CleanupTextures();
+    RenderScheduler::Shutdown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -163,5 +303,5 @@ int main()
     glfwDestroyWindow(window);
     glfwTerminate();
 
-    return 0;
+    return allocationCheck.failedFrames > 0 ? 1 : 0;
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+FrameArena::FrameArena(size_t capacity)
+    : block(static_cast<unsigned char*>(std::malloc(capacity))), blockSize(capacity)
+{
+    if (!block && capacity > 0) throw std::bad_alloc();
+}
+
+FrameArena::~FrameArena()
+{
+    freeOverflow();
+    std::free(block);
+}
+
+FrameArena& FrameArena::get()
+{
+    static FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+    size_t offset = (used + alignment - 1) & ~(alignment - 1);
+    if (offset + bytes <= blockSize) {
+        used = offset + bytes;
+        return block + offset;
+    }
+
+    // Out of room: chain a heap block for the rest of this frame. The header is
+    // padded to the alignment so the payload after it stays aligned.
+    size_t header = (sizeof(Overflow) + alignment - 1) & ~(alignment - 1);
+    Overflow* extra = static_cast<Overflow*>(std::malloc(header + bytes));
+    if (!extra) throw std::bad_alloc(); // Containers over FrameAllocator expect allocate() to succeed or throw
+    extra->next = overflow;
+    overflow = extra;
+    overflowBytes += bytes;
+    return reinterpret_cast<unsigned char*>(extra) + header;
+}
+
+void FrameArena::reset()
+{
+    peak = std::max(peak, used + overflowBytes);
+    if (overflow) {
+        freeOverflow();
+
+        // Grow so the next frame like this one fits in the main block
+        size_t grown = std::max(blockSize * 2, used + overflowBytes);
+        if (unsigned char* larger = static_cast<unsigned char*>(std::malloc(grown))) {
+            std::free(block);
+            block = larger;
+            blockSize = grown;
+        }
+        overflowBytes = 0;
+    }
+    used = 0;
+}
+
+void FrameArena::freeOverflow()
+{
+    while (overflow) {
+        Overflow* next = overflow->next;
+        std::free(overflow);
+        overflow = next;
+    }
+}
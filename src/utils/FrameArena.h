@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of the frame: UI scratch
+// strings, temporary lists. Allocating is a pointer increment, freeing is a no-op,
+// and reset() releases everything at once. When a frame needs more than the current
+// block, overflow blocks are chained; the next reset() replaces them with a single
+// block large enough for that frame, so a steady-state frame never touches the heap.
+//
+// Main thread only. Use FrameArena::get() for the frame arena that the main loop
+// resets after ImGui::Render().
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    static FrameArena& get();
+
+    // alignment must be a power of two, at most alignof(std::max_align_t). Throws std::bad_alloc
+    // when an overflow block cannot be allocated, like operator new.
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    void reset();
+
+    size_t capacity() const { return blockSize; }
+    size_t bytesUsed() const { return used + overflowBytes; }
+    size_t highWater() const { return peak; } // Most bytes one frame used since startup
+
+private:
+    void freeOverflow();
+
+    struct Overflow {
+        Overflow* next;
+    };
+
+    unsigned char* block = nullptr;
+    size_t blockSize = 0;
+    size_t used = 0;
+    Overflow* overflow = nullptr; // Blocks allocated after the main one filled up, freed on reset()
+    size_t overflowBytes = 0;
+    size_t peak = 0;
+};
+
+// std allocator over the frame arena; deallocate() does nothing
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() = default;
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>&) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(FrameArena::get().allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>&) const { return false; }
+};
+
+// Transient containers, valid until the frame arena is reset
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,78 @@
+#include "ImageOps.h"
+#include <algorithm>
+#include <cstring>
+
+void PremultiplyAlpha(unsigned char* rgba, int width, int height)
+{
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        unsigned char* pixel = rgba + i * 4;
+        unsigned alpha = pixel[3];
+        pixel[0] = static_cast<unsigned char>((pixel[0] * alpha + 127) / 255);
+        pixel[1] = static_cast<unsigned char>((pixel[1] * alpha + 127) / 255);
+        pixel[2] = static_cast<unsigned char>((pixel[2] * alpha + 127) / 255);
+    }
+}
+
+void ResizeImageArea(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight)
+{
+    // Each destination texel averages the source area it covers, weighting partially covered texels
+    float scaleX = static_cast<float>(srcWidth) / dstWidth;
+    float scaleY = static_cast<float>(srcHeight) / dstHeight;
+
+    for (int dy = 0; dy < dstHeight; ++dy) {
+        float y0 = dy * scaleY;
+        float y1 = y0 + scaleY;
+        for (int dx = 0; dx < dstWidth; ++dx) {
+            float x0 = dx * scaleX;
+            float x1 = x0 + scaleX;
+
+            float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            float totalWeight = 0.0f;
+            for (int sy = static_cast<int>(y0); sy < std::min(srcHeight, static_cast<int>(y1 + 0.999f)); ++sy) {
+                float weightY = std::min(y1, sy + 1.0f) - std::max(y0, static_cast<float>(sy));
+                for (int sx = static_cast<int>(x0); sx < std::min(srcWidth, static_cast<int>(x1 + 0.999f)); ++sx) {
+                    float weight = weightY * (std::min(x1, sx + 1.0f) - std::max(x0, static_cast<float>(sx)));
+                    if (weight <= 0.0f) continue;
+                    const unsigned char* pixel = src + (static_cast<size_t>(sy) * srcWidth + sx) * 4;
+                    for (int c = 0; c < 4; ++c) sum[c] += pixel[c] * weight;
+                    totalWeight += weight;
+                }
+            }
+
+            unsigned char* out = dst + (static_cast<size_t>(dy) * dstWidth + dx) * 4;
+            for (int c = 0; c < 4; ++c) {
+                out[c] = static_cast<unsigned char>(totalWeight > 0.0f ? std::min(255.0f, sum[c] / totalWeight + 0.5f) : 0.0f);
+            }
+        }
+    }
+}
+
+size_t GetMipChainBytes(int width, int height, int levelCount)
+{
+    size_t bytes = 0;
+    for (int level = 0; level < levelCount; ++level) {
+        bytes += static_cast<size_t>(std::max(1, width >> level)) * std::max(1, height >> level) * 4;
+    }
+    return bytes;
+}
+
+void BuildMipChain(const unsigned char* rgba, int width, int height, int levelCount, unsigned char* out)
+{
+    std::memcpy(out, rgba, static_cast<size_t>(width) * height * 4);
+
+    const unsigned char* previous = out;
+    int previousWidth = width;
+    int previousHeight = height;
+    unsigned char* next = out + static_cast<size_t>(width) * height * 4;
+    for (int level = 1; level < levelCount; ++level) {
+        int levelWidth = std::max(1, width >> level);
+        int levelHeight = std::max(1, height >> level);
+        ResizeImageArea(previous, previousWidth, previousHeight, next, levelWidth, levelHeight);
+
+        previous = next;
+        previousWidth = levelWidth;
+        previousHeight = levelHeight;
+        next += static_cast<size_t>(levelWidth) * levelHeight * 4;
+    }
+}
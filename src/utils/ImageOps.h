@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+
+// CPU-side RGBA8 helpers shared by the client and the asset bakers. No GL, no file IO.
+
+// Multiplies the color channels by alpha in place
+void PremultiplyAlpha(unsigned char* rgba, int width, int height);
+
+// Area-averaging resample, suitable for downscaling premultiplied RGBA by any ratio
+void ResizeImageArea(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight);
+
+// Bytes of a mip chain whose level i is max(1, width >> i) x max(1, height >> i)
+size_t GetMipChainBytes(int width, int height, int levelCount);
+
+// Writes level 0 (a copy of rgba) followed by each box-filtered level into out,
+// which must hold GetMipChainBytes() bytes. Expects premultiplied input.
+void BuildMipChain(const unsigned char* rgba, int width, int height, int levelCount, unsigned char* out);
@@ -31,4 +31,20 @@ GLuint LoadTextureFromFile(const char* path)
 
     stbi_image_free(data);
     return textureID;
-}
\ No newline at end of file
+}
+
+unsigned char* LoadImageData(const char* path, int* width, int* height)
+{
+    int channels;
+    unsigned char* data = stbi_load(path, width, height, &channels, 4); // Force RGBA
+    if (!data)
+    {
+        GLOG_ERROR("Failed to load image: {}", path);
+    }
+    return data;
+}
+
+void FreeImageData(unsigned char* data)
+{
+    stbi_image_free(data);
+}
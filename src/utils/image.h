@@ -2,3 +2,7 @@
 
 #include <glad/glad.h>
 GLuint LoadTextureFromFile(const char* filename);
+
+// Decodes an image file to tightly packed RGBA8. Free the result with FreeImageData().
+unsigned char* LoadImageData(const char* filename, int* width, int* height);
+void FreeImageData(unsigned char* data);
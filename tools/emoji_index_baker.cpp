@@ -0,0 +1,48 @@
+// Bakes assets/emojis/openmoji.json into the binary index that EmojiManager maps at startup.
+// Usage: emoji_index_baker <openmoji.json> <openmoji.idx>
+#include "EmojiIndex.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        std::cerr << "Usage: emoji_index_baker <openmoji.json> <openmoji.idx>" << std::endl;
+        return 1;
+    }
+
+    std::vector<unsigned char> image;
+    std::string error;
+    if (!EmojiIndexBuilder::BuildFromJson(argv[1], image, error)) {
+        std::cerr << "[emoji_index_baker] ERROR: " << error << std::endl;
+        return 1;
+    }
+
+    EmojiIndex index;
+    if (!index.open(image.data(), image.size())) {
+        std::cerr << "[emoji_index_baker] ERROR: Built index failed validation" << std::endl;
+        return 1;
+    }
+
+    // Write to a temporary file first so a running client never maps a half-written index
+    std::string tempPath = std::string(argv[2]) + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()))) {
+            std::cerr << "[emoji_index_baker] ERROR: Failed to write " << tempPath << std::endl;
+            return 1;
+        }
+    }
+    std::remove(argv[2]);
+    if (std::rename(tempPath.c_str(), argv[2]) != 0) {
+        std::cerr << "[emoji_index_baker] ERROR: Failed to move index into place: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "[emoji_index_baker] " << index.recordCount() << " emojis in " << index.categoryCount()
+              << " categories, " << image.size() << " bytes -> " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Bakes the emoji PNGs into the pre-decoded pack that EmojiManager maps at startup.
+// Usage: emoji_pack_baker <openmoji.json> <png directory> <openmoji.pack> [tier sizes, default 24 48]
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "EmojiIndex.h"
+#include "EmojiPack.h"
+#include "utils/ImageOps.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Emojis are drawn at 20-24 px; one tier per display scale
+static const uint32_t DEFAULT_TIER_SIZES[] = {24, 48};
+
+static unsigned char* LoadEmojiPng(const std::string& directory, std::string hexcode, int& width, int& height)
+{
+    int channels;
+    unsigned char* data = stbi_load((directory + "/" + hexcode + ".png").c_str(), &width, &height, &channels, 4);
+    if (!data) {
+        std::transform(hexcode.begin(), hexcode.end(), hexcode.begin(), ::tolower);
+        data = stbi_load((directory + "/" + hexcode + ".png").c_str(), &width, &height, &channels, 4);
+    }
+    return data;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        std::cerr << "Usage: emoji_pack_baker <openmoji.json> <png directory> <openmoji.pack> [tier sizes...]" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint32_t> tierSizes;
+    for (int i = 4; i < argc; ++i) {
+        int size = std::atoi(argv[i]);
+        if (size <= 0 || size > 1024) {
+            std::cerr << "[emoji_pack_baker] ERROR: Invalid tier size: " << argv[i] << std::endl;
+            return 1;
+        }
+        tierSizes.push_back(static_cast<uint32_t>(size));
+    }
+    if (tierSizes.empty()) tierSizes.assign(std::begin(DEFAULT_TIER_SIZES), std::end(DEFAULT_TIER_SIZES));
+
+    // Emoji ids must match the metadata index, so build it the same way the client does
+    std::vector<unsigned char> indexImage;
+    std::string error;
+    EmojiIndex index;
+    if (!EmojiIndexBuilder::BuildFromJson(argv[1], indexImage, error) || !index.open(indexImage.data(), indexImage.size())) {
+        std::cerr << "[emoji_pack_baker] ERROR: " << (error.empty() ? "Built index failed validation" : error) << std::endl;
+        return 1;
+    }
+
+    uint32_t recordCount = index.recordCount();
+    uint32_t tierCount = static_cast<uint32_t>(tierSizes.size());
+    std::vector<EmojiPackTier> tiers;
+    for (uint32_t size : tierSizes) tiers.push_back(EmojiPackTier{size, 0});
+    std::vector<EmojiPackEntry> entries(static_cast<size_t>(tierCount) * recordCount, EmojiPackEntry{EMOJI_PACK_MISSING, 0, 0, 0});
+    std::vector<unsigned char> pixels;
+    std::vector<unsigned char> resized;
+    uint32_t missing = 0;
+
+    for (uint32_t id = 0; id < recordCount; ++id) {
+        int width, height;
+        unsigned char* source = LoadEmojiPng(argv[2], std::string(index.text(EMOJI_TEXT_HEXCODE, id)), width, height);
+        if (!source) {
+            missing++;
+            continue;
+        }
+
+        // Filter in premultiplied space so transparent texels do not darken the edges
+        PremultiplyAlpha(source, width, height);
+
+        for (uint32_t tier = 0; tier < tierCount; ++tier) {
+            // Fit the longer side to the tier size, never upscale
+            float scale = std::min(1.0f, static_cast<float>(tierSizes[tier]) / std::max(width, height));
+            int tierWidth = std::max(1, static_cast<int>(width * scale + 0.5f));
+            int tierHeight = std::max(1, static_cast<int>(height * scale + 0.5f));
+            resized.resize(static_cast<size_t>(tierWidth) * tierHeight * 4);
+            ResizeImageArea(source, width, height, resized.data(), tierWidth, tierHeight);
+
+            EmojiPackEntry& entry = entries[static_cast<size_t>(tier) * recordCount + id];
+            entry.offset = pixels.size();
+            entry.width = static_cast<uint16_t>(tierWidth);
+            entry.height = static_cast<uint16_t>(tierHeight);
+            pixels.resize(pixels.size() + GetMipChainBytes(tierWidth, tierHeight, EMOJI_PACK_MIP_COUNT));
+            BuildMipChain(resized.data(), tierWidth, tierHeight, EMOJI_PACK_MIP_COUNT, pixels.data() + entry.offset);
+        }
+        stbi_image_free(source);
+    }
+
+    EmojiPackHeader header{};
+    header.magic = EMOJI_PACK_MAGIC;
+    header.version = EMOJI_PACK_VERSION;
+    if (!EmojiIndexBuilder::GetSourceStamp(argv[1], header.sourceSize, header.sourceTime)) {
+        std::cerr << "[emoji_pack_baker] ERROR: Failed to stat " << argv[1] << std::endl;
+        return 1;
+    }
+    header.recordCount = recordCount;
+    header.tierCount = tierCount;
+    header.mipCount = EMOJI_PACK_MIP_COUNT;
+    header.tiersOffset = sizeof(EmojiPackHeader);
+    header.entriesOffset = header.tiersOffset + tierCount * sizeof(EmojiPackTier);
+    header.pixelsOffset = static_cast<uint32_t>((header.entriesOffset + entries.size() * sizeof(EmojiPackEntry) + 7) & ~size_t(7));
+    header.pixelsSize = pixels.size();
+
+    // Write to a temporary file first so a running client never maps a half-written pack
+    std::string tempPath = std::string(argv[3]) + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        std::vector<char> padding(header.pixelsOffset - header.entriesOffset - entries.size() * sizeof(EmojiPackEntry), 0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(tiers.data()), static_cast<std::streamsize>(tiers.size() * sizeof(EmojiPackTier)));
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(EmojiPackEntry)));
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        if (!out) {
+            std::cerr << "[emoji_pack_baker] ERROR: Failed to write " << tempPath << std::endl;
+            return 1;
+        }
+    }
+    std::remove(argv[3]);
+    if (std::rename(tempPath.c_str(), argv[3]) != 0) {
+        std::cerr << "[emoji_pack_baker] ERROR: Failed to move pack into place: " << argv[3] << std::endl;
+        return 1;
+    }
+
+    std::cout << "[emoji_pack_baker] " << recordCount - missing << " of " << recordCount << " emojis in " << tierCount
+              << " tiers, " << header.pixelsOffset + pixels.size() << " bytes -> " << argv[3] << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Measures GLog line formatting throughput: the compiled GLogPattern against the
+// previous formatter, which re-parsed the pattern string for every line.
+// Usage: glog_bench [lines per thread] [pattern]
+#include "debug/GLogPattern.h"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ✅ The formatter GLog used before patterns were compiled, kept here as the baseline
+static std::string legacyTimestamp(int64_t timestampNs) {
+    std::time_t nowTime = static_cast<std::time_t>(timestampNs / 1000000000);
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &nowTime);
+#else
+    localtime_r(&nowTime, &localTime);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&localTime, "[%Y-%m-%d %H:%M:%S]");
+    return oss.str();
+}
+
+static std::string legacyFormat(const std::string& logPattern, GLogLevel level, const std::string& message, int64_t timestampNs, uint64_t threadId) {
+    std::string timestamp = legacyTimestamp(timestampNs);
+    std::unordered_map<std::string, std::string> replacements = {
+        {"%Y", timestamp.substr(1, 4)},
+        {"%m", timestamp.substr(6, 2)},
+        {"%d", timestamp.substr(9, 2)},
+        {"%H", timestamp.substr(12, 2)},
+        {"%M", timestamp.substr(15, 2)},
+        {"%S", timestamp.substr(18, 2)},
+        {"%e", "000"},
+        {"%l", level == GLogLevel::GLOG_INFO ? "INFO" : "WARNING"},
+        {"%v", message},
+        {"%t", std::to_string(threadId)},
+        {"%n", "GLog"}
+    };
+
+    std::string formattedPattern = logPattern;
+    size_t pos = formattedPattern.find("%^");
+    if (pos != std::string::npos) formattedPattern.replace(pos, 2, "\033[1;33m");
+    pos = formattedPattern.find("%$");
+    if (pos != std::string::npos) formattedPattern.replace(pos, 2, "\033[0m");
+
+    for (const auto& [key, value] : replacements) {
+        size_t pos = 0;
+        while ((pos = formattedPattern.find(key, pos)) != std::string::npos) {
+            formattedPattern.replace(pos, key.length(), value);
+            pos += value.length();
+        }
+    }
+    return formattedPattern + "\n";
+}
+
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// ✅ Runs `threads` producers that share one formatter behind a mutex, like GLog does
+template <typename FormatLine>
+static double measureLinesPerSecond(int threads, size_t linesPerThread, FormatLine formatLine) {
+    std::mutex formatMutex;
+    size_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::string message = "Rendered frame " + std::to_string(t) + " with 42 draw calls";
+            for (size_t i = 0; i < linesPerThread; ++i) {
+                int64_t timestampNs = nowNs();
+                std::lock_guard<std::mutex> lock(formatMutex);
+                checksum += formatLine(message, timestampNs, static_cast<uint64_t>(t + 1));
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (checksum == 0) std::cerr << "[glog_bench] WARNING: Nothing was formatted" << std::endl;
+    return static_cast<double>(linesPerThread) * threads / seconds;
+}
+
+int main(int argc, char** argv)
+{
+    size_t linesPerThread = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::string pattern = argc > 2 ? argv[2] : "[%Y-%m-%d %H:%M:%S.%e] [%t] [%l] %v";
+
+    GLogPattern compiled(pattern);
+    fmt::memory_buffer buffer;
+    std::string line;
+
+    auto runLegacy = [&](const std::string& message, int64_t timestampNs, uint64_t threadId) {
+        return legacyFormat(pattern, GLogLevel::GLOG_INFO, message, timestampNs, threadId).size();
+    };
+    auto runCompiled = [&](const std::string& message, int64_t timestampNs, uint64_t threadId) {
+        buffer.clear();
+        GLogRecord record{GLogLevel::GLOG_INFO, false, timestampNs, threadId, GLogSourceLocation{}, message, 0, message};
+        compiled.format(buffer, record);
+        buffer.push_back('\n');
+        line.assign(buffer.data(), buffer.size());
+        return line.size();
+    };
+
+    std::cout << "Pattern: " << pattern << "\n";
+    for (int threads : {1, 4}) {
+        double legacy = measureLinesPerSecond(threads, linesPerThread, runLegacy);
+        double current = measureLinesPerSecond(threads, linesPerThread, runCompiled);
+        std::cout << std::fixed << std::setprecision(0)
+                  << threads << " thread(s): legacy " << legacy << " lines/s, compiled " << current << " lines/s ("
+                  << std::setprecision(1) << current / legacy << "x)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Turns a binary GLog file (see GLogBinary.h, written by BinaryFileSink) back into text.
+// Usage: glog_decode <log.glb> [pattern]
+#include "debug/GLogBinary.h"
+#include "debug/GLogPattern.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Reader {
+public:
+    explicit Reader(std::ifstream& in) : in(in) {}
+
+    template <typename T>
+    bool read(T& value) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value))); }
+
+    bool readBytes(std::string& out, size_t size) {
+        out.resize(size);
+        return size == 0 || static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(size)));
+    }
+
+    bool readString(std::string& out) {
+        uint16_t length;
+        return read(length) && readBytes(out, length);
+    }
+
+private:
+    std::ifstream& in;
+};
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: glog_decode <log.glb> [pattern]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "[glog_decode] ERROR: Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    Reader reader(in);
+    uint32_t magic = 0;
+    uint16_t version = 0, reserved = 0;
+    if (!reader.read(magic) || !reader.read(version) || !reader.read(reserved) || magic != GLOG_BINARY_MAGIC) {
+        std::cerr << "[glog_decode] ERROR: Not a binary GLog file" << std::endl;
+        return 1;
+    }
+    if (version != GLOG_BINARY_VERSION) {
+        std::cerr << "[glog_decode] ERROR: Unsupported version " << version << std::endl;
+        return 1;
+    }
+
+    GLogPattern pattern(argc > 2 ? argv[2] : "[%Y-%m-%d %H:%M:%S.%e] [%t] [%l] %v");
+    std::unordered_map<uint32_t, GLogFormatInfo> formats;
+    fmt::memory_buffer message;
+    fmt::memory_buffer line;
+    std::string payload;
+    size_t recordCount = 0;
+
+    GLogBinaryEntry entry;
+    while (reader.read(entry)) {
+        if (entry == GLogBinaryEntry::Format) {
+            uint32_t id;
+            GLogFormatInfo format;
+            uint8_t argCount;
+            std::string argTypes;
+            if (!reader.read(id) || !reader.read(format.level) || !reader.read(format.line) || !reader.readString(format.file) ||
+                !reader.readString(format.format) || !reader.read(argCount) || !reader.readBytes(argTypes, argCount)) {
+                break;
+            }
+            for (char type : argTypes) format.argTypes.push_back(static_cast<GLogArgType>(type));
+            formats[id] = std::move(format);
+            continue;
+        }
+
+        if (entry != GLogBinaryEntry::Record) {
+            std::cerr << "[glog_decode] ERROR: Corrupt entry after " << recordCount << " records" << std::endl;
+            return 1;
+        }
+
+        uint32_t formatId;
+        GLogLevel level;
+        uint8_t truncated;
+        int64_t timestampNs;
+        uint64_t threadId;
+        uint16_t payloadSize;
+        if (!reader.read(formatId) || !reader.read(level) || !reader.read(truncated) || !reader.read(timestampNs) ||
+            !reader.read(threadId) || !reader.read(payloadSize) || !reader.readBytes(payload, payloadSize)) {
+            break;
+        }
+
+        message.clear();
+        if (formatId == 0) {
+            message.append(payload);
+        } else if (auto it = formats.find(formatId); it != formats.end()) {
+            GLogBinary::formatMessage(it->second.format, it->second.argTypes, payload.data(), payload.size(), message);
+        } else {
+            fmt::format_to(std::back_inserter(message), "<unknown format {}>", formatId);
+        }
+        if (truncated) message.append(std::string_view("..."));
+
+        line.clear();
+        GLogRecord record{level, truncated != 0, timestampNs, threadId, GLogSourceLocation{}, std::string_view(message.data(), message.size()), formatId, payload};
+        if (auto it = formats.find(formatId); it != formats.end()) record.source = GLogSourceLocation{it->second.file.c_str(), it->second.line};
+        pattern.format(line, record);
+        line.push_back('\n');
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        ++recordCount;
+    }
+
+    // A log cut off by a crash ends in a partial entry, everything before it is still printed
+    if (!in.eof()) {
+        std::cerr << "[glog_decode] WARNING: Unexpected read error after " << recordCount << " records" << std::endl;
+    }
+    return 0;
+}